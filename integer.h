@@ -4,8 +4,36 @@
 #include <immer/vector_transient.hpp>
 #include <immer/flex_vector.hpp>
 #include <immer/flex_vector_transient.hpp>
+#include <immer/algorithm.hpp>
 #include <utility>
-#include <sstream>
+#include <tuple>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+#include <cmath>
+#include <type_traits>
+#include <cstring>
+#include <array>
+#include <charconv>
+#include <system_error>
+#include <istream>
+#include <cctype>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include <ostream>
+#include <mutex>
 
 namespace int_titan
 {
@@ -17,6 +45,23 @@ namespace int_titan
         using superdigit = uint64_t;
         static constexpr digit max_digit = std::numeric_limits<digit>::max();
         using integer_digits = immer::flex_vector<digit>;
+        // Precomputed reciprocal of a divisor, for repeated division by the same value.
+        class reciprocal;
+        // Native integer types that convert to and from integer: the standard ones (except bool, which is not taken for a number) and,
+        // where the compiler has them, the 128-bit ones.
+        template<typename T>
+        static constexpr bool is_native_integer = (std::is_integral_v<T> and !std::is_same_v<T, bool>)
+#if defined(__SIZEOF_INT128__)
+            or std::is_same_v<T, __int128> or std::is_same_v<T, unsigned __int128>
+#endif
+            ;
+        // Zero.
+        integer() = default;
+        // From a native integer.
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        integer(const T value) : digits(digits_from_native(value)), is_negative(is_negative_native(value))
+        {
+        }
         // From base 2^32 digits (native representation).
         static integer create(const integer_digits& digits, const bool is_negative)
         {
@@ -25,8 +70,8 @@ namespace int_titan
             x.is_negative = is_negative;
             return x;
         }
-        // From string representation in decimal or hexadecimal.
-        static integer create(std::string_view str, const bool is_hex = true)
+        // From string representation in a radix from 2 to 36 (the digits past 9 being letters in either case).
+        static integer create(std::string_view str, const int radix = 16)
         {
             bool is_negative = false;
             if(!str.empty() and (str[0] == '-' or str[0] == '+'))
@@ -34,21 +79,450 @@ namespace int_titan
                 is_negative = str[0] == '-';
                 str = str.substr(1);
             }
-            // Currently, only hex is supported.
-            assert(is_hex);
-            return create(digits_from_string(str, is_hex), is_negative);
+            return create(digits_from_string(str, radix), is_negative);
         }
+        // The radix used to be a hex flag, which would now silently turn into radix 0 or 1.
+        static integer create(std::string_view str, bool is_hex) = delete;
         // Zero value.
         static const integer zero;
         // Unit value.
         static const integer one;
-        // Convert integer to string.
-        static std::string to_string(const integer& x, const bool is_hex = true, const bool uppercase = true)
+        // Convert integer to string in a radix from 2 to 36.
+        static std::string to_string(const integer& x, const int radix = 16, const bool uppercase = true)
+        {
+            return string_from_integer(x, radix, uppercase);
+        }
+        static std::string to_string(const integer& x, bool is_hex, bool uppercase = true) = delete;
+        // Convert to a native integer type, throwing std::overflow_error if x is outside of its range.
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        static T to(const integer& x)
+        {
+            const bool is_negative = x.is_negative and !x.digits.empty();
+            // The largest magnitude of the type, on the side of the sign of x.
+            constexpr std::size_t magnitude_bits = 8 * sizeof(T) - (is_signed_native<T> ? 1 : 0);
+            const native_magnitude limit = is_negative ? (is_signed_native<T> ? native_magnitude(1) << magnitude_bits : 0)
+                                                       : ~native_magnitude(0) >> (8 * sizeof(native_magnitude) - magnitude_bits);
+            if(bit_length(x) > 8 * sizeof(native_magnitude))
+            {
+                throw std::overflow_error("Value outside of the range of the type.");
+            }
+            native_magnitude magnitude = 0;
+            for(auto it = x.digits.rbegin(); it != x.digits.rend(); ++it)
+            {
+                magnitude = (magnitude << 16 << 16) | *it;
+            }
+            if(magnitude > limit)
+            {
+                throw std::overflow_error("Value outside of the range of the type.");
+            }
+            return static_cast<T>(is_negative ? -magnitude : magnitude);
+        }
+        // The nearest double (ties to even), or an infinity if x is out of its range. Only the top bits and whether any bit below them
+        // is set are read.
+        static double to_double(const integer& x)
+        {
+            return to_floating<double>(x);
+        }
+        // The nearest long double (ties to even), or an infinity if x is out of its range.
+        static long double to_long_double(const integer& x)
+        {
+            return to_floating<long double>(x);
+        }
+        // From a finite double, truncated towards zero.
+        static integer from_double(const double value)
+        {
+            return from_floating(value);
+        }
+        // From a finite long double, truncated towards zero.
+        static integer from_long_double(const long double value)
+        {
+            return from_floating(value);
+        }
+        // Number of decimal digits of |x| (1 for 0). It follows from the bit length, but for values just around a power of ten, which
+        // are compared with it.
+        static std::size_t decimal_digit_count(const integer& x)
+        {
+            const std::size_t length = bit_length(x);
+            if(length <= 64)
+            {
+                superdigit w = static_cast<superdigit>(magnitude_bits(x, 0, length));
+                std::size_t count = 1;
+                for(; w >= 10; w /= 10)
+                {
+                    count++;
+                }
+                return count;
+            }
+            long double fraction;
+            return decimal_exponent(x, length, fraction) + 1;
+        }
+        // |x| in scientific notation with 'significant_digits' digits, correctly rounded (ties to even), e.g. "3.14159e1234567" (with a
+        // leading minus sign if x is negative). Beyond the bit length, only the top digits of x are read, but for the rare values
+        // too close to a rounding boundary, whose leading digits are then found by an exact division.
+        static std::string approximate_decimal(const integer& x, const std::size_t significant_digits = 6)
+        {
+            if(significant_digits == 0)
+            {
+                throw std::logic_error("Significant digits of 0 impermissible.");
+            }
+            std::string digits;
+            std::size_t exponent = 0;
+            const std::size_t length = bit_length(x);
+            long double fraction = 0;
+            if(length > 64)
+            {
+                exponent = decimal_exponent(x, length, fraction);
+            }
+            // The leading digits are 10^(fraction + significant digits - 1), rounded, when long double holds them with room to spare.
+            if(length > 64 and significant_digits + 3 <= std::numeric_limits<long double>::digits10)
+            {
+                const long double value = std::pow(10.0L, fraction + static_cast<long double>(significant_digits - 1));
+                const long double whole = std::floor(value);
+                if(std::fabs(value - whole - 0.5L) > value * 64 * std::numeric_limits<long double>::epsilon())
+                {
+                    digits = std::to_string(static_cast<superdigit>(value - whole < 0.5L ? whole : whole + 1));
+                }
+            }
+            if(digits.empty())
+            {
+                if(length <= 64)
+                {
+                    exponent = decimal_digit_count(x) - 1;
+                }
+                digits = leading_decimal_digits(x, exponent + 1, significant_digits);
+            }
+            // Rounding up may have carried into a new digit.
+            if(digits.size() > significant_digits)
+            {
+                digits.pop_back();
+                exponent++;
+            }
+            std::string result = x.is_negative and !x.digits.empty() ? "-" : "";
+            result += digits[0];
+            if(significant_digits > 1)
+            {
+                result += '.';
+                result.append(digits, 1, std::string::npos);
+            }
+            return result + 'e' + std::to_string(exponent);
+        }
+        // Upper bound on the number of characters of x in a radix from 2 to 36 (sign included), for sizing the buffers of to_chars.
+        static std::size_t max_chars(const integer& x, const int radix = 10)
+        {
+            check_radix(radix);
+            return (x.is_negative and !x.digits.empty() ? 1 : 0) + magnitude_max_chars(x.digits, radix);
+        }
+        // Write x into [first, last) in a radix from 2 to 36, like std::to_chars: in lowercase, and with nothing written but
+        // std::errc::value_too_large if it does not fit. Given at least max_chars(x, radix) characters, nothing is allocated.
+        static std::to_chars_result to_chars(char* first, char* last, const integer& x, const int radix = 10)
+        {
+            if(radix < 2 or radix > 36)
+            {
+                return {last, std::errc::invalid_argument};
+            }
+            const std::size_t size = last - first;
+            // Values of up to two digits are written on the stack first, which needs neither the bound nor a check of the radix path.
+            if(x.digits.size() <= 2)
+            {
+                char buffer[65];
+                char* const buffer_last = buffer + sizeof(buffer);
+                char* buffer_first = write_word(word_from_digits(x.digits), buffer_last, radix, false);
+                if(x.is_negative and !x.digits.empty())
+                {
+                    *--buffer_first = '-';
+                }
+                if(static_cast<std::size_t>(buffer_last - buffer_first) > size)
+                {
+                    return {last, std::errc::value_too_large};
+                }
+                return {std::copy(buffer_first, buffer_last, first), std::errc()};
+            }
+            if(size >= max_chars(x, radix))
+            {
+                return {write_characters(first, x, radix, false), std::errc()};
+            }
+            // The buffer is below the bound, but the value may still fit.
+            const std::string str = string_from_integer(x, radix, false);
+            if(str.size() > size)
+            {
+                return {last, std::errc::value_too_large};
+            }
+            return {std::copy(str.begin(), str.end(), first), std::errc()};
+        }
+        // Read an integer from [first, last) in a radix from 2 to 36, like std::from_chars: an optional minus sign followed by as many
+        // digits as there are, with std::errc::invalid_argument (and 'value' left alone) if there are none.
+        static std::from_chars_result from_chars(const char* first, const char* last, integer& value, const int radix = 10)
+        {
+            if(radix < 2 or radix > 36)
+            {
+                return {first, std::errc::invalid_argument};
+            }
+            const bool is_negative = first != last and *first == '-';
+            const char* const begin = first + (is_negative ? 1 : 0);
+            const char* end = begin;
+            while(end != last and get_digit_character_value(*end) < radix)
+            {
+                end++;
+            }
+            if(end == begin)
+            {
+                return {first, std::errc::invalid_argument};
+            }
+            const std::string_view str(begin, end - begin);
+            // A single chunk is converted inline, without going through the chunk vector.
+            const integer_digits digits = str.size() <= radix_chunk_size(radix)
+                    ? digits_from_word(radix_chunk_value(str.data(), str.size(), radix))
+                    : digits_from_string(str, radix);
+            value = create(digits, is_negative and !digits.empty());
+            return {end, std::errc()};
+        }
+        // Binary format: a 24-byte header (the magic "ITTN", a 16-bit version, a sign byte, a reserved zero byte, a 64-bit digit count and
+        // a 64-bit checksum of the sign, the count and the digits), followed by the digits, all little-endian.
+        static constexpr std::uint16_t serialization_version = 1;
+        static constexpr std::size_t serialization_header_size = 24;
+        // Number of bytes x takes in the binary format.
+        static std::size_t serialized_size(const integer& x)
+        {
+            return serialization_header_size + 4 * x.digits.size();
+        }
+        // Write x in the binary format into a buffer of at least serialized_size(x) bytes (returns the number of bytes written).
+        static std::size_t serialize(const integer& x, unsigned char* buffer)
+        {
+            write_serialization_header(x, buffer);
+            unsigned char* position = buffer + serialization_header_size;
+            immer::for_each_chunk(x.digits, [&position](const digit* first, const digit* last)
+            {
+                position = store_digits(first, last - first, position);
+            });
+            return position - buffer;
+        }
+        // Write x in the binary format to a stream.
+        static void serialize(const integer& x, std::ostream& out)
+        {
+            unsigned char header[serialization_header_size];
+            write_serialization_header(x, header);
+            out.write(reinterpret_cast<const char*>(header), sizeof(header));
+            unsigned char block[4 * serialization_block_size];
+            immer::for_each_chunk(x.digits, [&out, &block](const digit* first, const digit* last)
+            {
+                for(; first != last; first += std::min<std::size_t>(last - first, serialization_block_size))
+                {
+                    const std::size_t count = std::min<std::size_t>(last - first, serialization_block_size);
+                    store_digits(first, count, block);
+                    out.write(reinterpret_cast<const char*>(block), 4 * count);
+                }
+            });
+        }
+        // Read an integer in the binary format from a buffer, checking its header and checksum.
+        static integer deserialize(const unsigned char* buffer, const std::size_t size)
+        {
+            if(size < serialization_header_size)
+            {
+                throw std::runtime_error("Invalid serialized integer.");
+            }
+            bool is_negative;
+            superdigit checksum;
+            const std::size_t count = read_serialization_header(buffer, is_negative, checksum);
+            if(count > (size - serialization_header_size) / 4)
+            {
+                throw std::runtime_error("Invalid serialized integer.");
+            }
+            const unsigned char* position = buffer + serialization_header_size;
+            return load_digits(count, is_negative, checksum, [&position](digit* block, const std::size_t size)
+            {
+                load_digits(position, size, block);
+                position += 4 * size;
+            });
+        }
+        // Read an integer in the binary format from a stream, checking its header and checksum.
+        static integer deserialize(std::istream& in)
+        {
+            unsigned char header[serialization_header_size];
+            if(!in.read(reinterpret_cast<char*>(header), sizeof(header)))
+            {
+                throw std::runtime_error("Invalid serialized integer.");
+            }
+            bool is_negative;
+            superdigit checksum;
+            const std::size_t count = read_serialization_header(header, is_negative, checksum);
+            std::vector<unsigned char> bytes;
+            return load_digits(count, is_negative, checksum, [&in, &bytes](digit* block, const std::size_t size)
+            {
+                bytes.resize(4 * size);
+                if(!in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+                {
+                    throw std::runtime_error("Invalid serialized integer.");
+                }
+                load_digits(bytes.data(), size, block);
+            });
+        }
+        // Byte or word order for import_bytes and export_bytes (for words, little means the least significant one first).
+        enum class endian
+        {
+            little,
+            big,
+            native
+        };
+        // Build a non-negative integer from 'count' words of 'word_size' bytes each, in the given word and byte orders (like mpz_import).
+        static integer import_bytes(const unsigned char* data, const std::size_t count, const std::size_t word_size, const endian word_order,
+                                    const endian byte_order)
+        {
+            if(word_size == 0)
+            {
+                throw std::logic_error("Word size of 0 impermissible.");
+            }
+            if(count > std::numeric_limits<std::size_t>::max() / word_size)
+            {
+                throw std::logic_error("Byte count too large.");
+            }
+            const std::size_t total = count * word_size;
+            digit_buffer result((total + 3) / 4);
+            const bool is_little_word = resolve_endian(word_order) == endian::little;
+            const bool is_little_byte = resolve_endian(byte_order) == endian::little or word_size == 1;
+            const std::size_t full_digits = total / 4;
+            if(is_little_word and is_little_byte)
+            {
+                // The data is a single little-endian byte string.
+                load_digits(data, full_digits, result.data());
+                for(std::size_t i = 4 * full_digits; i < total; i++)
+                {
+                    result[i / 4] |= static_cast<digit>(data[i]) << (8 * (i % 4));
+                }
+            }
+            else if(!is_little_word and !is_little_byte)
+            {
+                // The data is a single big-endian byte string, read backwards a digit (and a byte swap) at a time.
+                for(std::size_t k = 0; k < full_digits; k++)
+                {
+                    const unsigned char* bytes = data + total - 4 * k - 4;
+                    result[k] = (static_cast<digit>(bytes[0]) << 24) | (static_cast<digit>(bytes[1]) << 16) | (static_cast<digit>(bytes[2]) << 8) | bytes[3];
+                }
+                for(std::size_t i = 4 * full_digits; i < total; i++)
+                {
+                    result[i / 4] |= static_cast<digit>(data[total - 1 - i]) << (8 * (i % 4));
+                }
+            }
+            else
+            {
+                for(std::size_t i = 0; i < total; i++)
+                {
+                    result[i / 4] |= static_cast<digit>(data[byte_position(i, count, word_size, is_little_word, is_little_byte)]) << (8 * (i % 4));
+                }
+            }
+            trim(result);
+            return create(digits_from_buffer(result), false);
+        }
+        // Number of words of 'word_size' bytes that |x| takes (0 for 0).
+        static std::size_t export_size(const integer& x, const std::size_t word_size)
+        {
+            if(word_size == 0)
+            {
+                throw std::logic_error("Word size of 0 impermissible.");
+            }
+            // Rounded up without adding word_size - 1, which could wrap around.
+            const std::size_t bytes = (bit_length(x) + 7) / 8;
+            return bytes / word_size + (bytes % word_size != 0 ? 1 : 0);
+        }
+        // Write |x| as words of 'word_size' bytes, in the given word and byte orders, into a buffer of 'capacity' such words (like
+        // mpz_export). Returns the number of words written, which is export_size(x, word_size).
+        static std::size_t export_bytes(unsigned char* buffer, const std::size_t capacity, const integer& x, const std::size_t word_size,
+                                        const endian word_order, const endian byte_order)
+        {
+            const std::size_t count = export_size(x, word_size);
+            if(count > capacity)
+            {
+                throw std::logic_error("Buffer too small.");
+            }
+            if(count > std::numeric_limits<std::size_t>::max() / word_size)
+            {
+                throw std::logic_error("Byte count too large.");
+            }
+            const std::size_t total = count * word_size;
+            const digit_buffer magnitude = buffer_from_digits(x.digits);
+            const auto byte = [&magnitude](const std::size_t i)
+            {
+                return static_cast<unsigned char>(i / 4 < magnitude.size() ? magnitude[i / 4] >> (8 * (i % 4)) : 0);
+            };
+            const bool is_little_word = resolve_endian(word_order) == endian::little;
+            const bool is_little_byte = resolve_endian(byte_order) == endian::little or word_size == 1;
+            const std::size_t full_digits = std::min(total / 4, magnitude.size());
+            if(is_little_word and is_little_byte)
+            {
+                store_digits(magnitude.data(), full_digits, buffer);
+                for(std::size_t i = 4 * full_digits; i < total; i++)
+                {
+                    buffer[i] = byte(i);
+                }
+            }
+            else if(!is_little_word and !is_little_byte)
+            {
+                for(std::size_t k = 0; k < full_digits; k++)
+                {
+                    unsigned char* bytes = buffer + total - 4 * k - 4;
+                    const digit d = magnitude[k];
+                    bytes[0] = static_cast<unsigned char>(d >> 24);
+                    bytes[1] = static_cast<unsigned char>(d >> 16);
+                    bytes[2] = static_cast<unsigned char>(d >> 8);
+                    bytes[3] = static_cast<unsigned char>(d);
+                }
+                for(std::size_t i = 4 * full_digits; i < total; i++)
+                {
+                    buffer[total - 1 - i] = byte(i);
+                }
+            }
+            else
+            {
+                for(std::size_t i = 0; i < total; i++)
+                {
+                    buffer[byte_position(i, count, word_size, is_little_word, is_little_byte)] = byte(i);
+                }
+            }
+            return count;
+        }
+#if defined(__unix__) || defined(__APPLE__)
+        // Read an integer in the binary format from a file, which is memory-mapped rather than read through a stream. The digits are copied
+        // from the mapping into the vector a block (serialization_block_size digits) at a time, as by deserialize.
+        static integer load(const char* path)
         {
-            // Currently, only hex is supported.
-            assert(is_hex);
-            return string_from_integer(x, is_hex, uppercase);
+            const int fd = ::open(path, O_RDONLY);
+            if(fd < 0)
+            {
+                throw std::runtime_error("Opening the file failed.");
+            }
+            struct stat status{};
+            if(::fstat(fd, &status) != 0)
+            {
+                ::close(fd);
+                throw std::runtime_error("Opening the file failed.");
+            }
+            const auto size = static_cast<std::size_t>(status.st_size);
+            // A file too short for the header is not in the format (and an empty one could not be mapped).
+            if(size < serialization_header_size)
+            {
+                ::close(fd);
+                throw std::runtime_error("Invalid serialized integer.");
+            }
+            void* const mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            // The mapping outlives the descriptor.
+            ::close(fd);
+            if(mapping == MAP_FAILED)
+            {
+                throw std::runtime_error("Mapping the file failed.");
+            }
+            ::madvise(mapping, size, MADV_SEQUENTIAL);
+            try
+            {
+                integer x = deserialize(static_cast<const unsigned char*>(mapping), size);
+                ::munmap(mapping, size);
+                return x;
+            }
+            catch(...)
+            {
+                ::munmap(mapping, size);
+                throw;
+            }
         }
+#endif
         // Negate the integer.
         static integer negate(integer x)
         {
@@ -84,9 +558,9 @@ namespace int_titan
             int carry = 0;
             for(int i = 0; i < std::max(x.digits.size(), y.digits.size()); i++)
             {
-                digit sum = get_digit(x, i) + get_digit(y, i) + carry;
-                carry = sum < get_digit(x, i) ? 1 : 0; // Check for integer overflow.
-                result.push_back(sum);
+                const superdigit sum = static_cast<superdigit>(get_digit(x, i)) + get_digit(y, i) + carry;
+                carry = static_cast<int>(sum >> 32); // Check for integer overflow.
+                result.push_back(static_cast<digit>(sum));
             }
             if(carry == 1) // Add another digit if carry is on.
             {
@@ -107,7 +581,7 @@ namespace int_titan
             // -x - (-y) = y - x
             if (x.is_negative and y.is_negative)
             {
-                return negate(subtract(negate(y), negate(x)));
+                return subtract(negate(y), negate(x));
             }
             // -x - y = -(x + y)
             else if (x.is_negative and !y.is_negative)
@@ -123,18 +597,10 @@ namespace int_titan
             int borrow = 0;
             for (int i = 0; i < std::max(x.digits.size(), y.digits.size()); i++)
             {
-                digit diff;
-                if (get_digit(x, i) - borrow >= get_digit(y, i)) // No underflow.
-                {
-                    diff = get_digit(x, i) - borrow - get_digit(y, i);
-                    borrow = 0;
-                }
-                else // Underflow. Borrow set to 1 and inverse digit applied.
-                {
-                    diff = inverse_digit(get_digit(y, i) - (get_digit(x, i) - borrow));
-                    borrow = 1;
-                }
-                result.push_back(diff);
+                // On underflow, the difference wraps around and the high half of the superdigit is all ones.
+                const superdigit diff = static_cast<superdigit>(get_digit(x, i)) - get_digit(y, i) - borrow;
+                borrow = static_cast<int>(diff >> 32) & 1;
+                result.push_back(static_cast<digit>(diff));
             }
             // Remove leading 0s.
             while (!result.empty() and result[result.size() - 1] == 0)
@@ -144,163 +610,535 @@ namespace int_titan
             return create(result.persistent(), false);
         }
         // Shift left (multiply by 10^amount, base 2^32), basically adding 'amount' zeroes.
+        // The zeroes are a shared vector concatenated in front of the digits, which is O(log n) instead of a push_front per digit.
         static integer shift_left(integer x, const int amount)
         {
-            if(is_equal_to(x, zero))
+            if(is_equal_to(x, zero) or amount <= 0)
             {
                 return x;
             }
-            for(int i = 0; i < amount; i++)
-            {
-                x.digits = x.digits.push_front(0);
-            }
+            x.digits = zero_digits(amount) + std::move(x.digits);
             return x;
         }
         // Shift right (divide by 10^amount, base 2^32), basically removing 'amount' digits from the right.
-        static integer shift_right(const integer& x, const int amount)
-        {
-            return create(x.digits.drop(amount), x.is_negative);
-        }
-        // Multiply two integers.
-        static integer multiply(integer x, integer y)
+        // The digits are moved into the drop, so that a uniquely owned vector is trimmed in place rather than copied.
+        static integer shift_right(integer x, const int amount)
         {
-            if(y.digits.size() > x.digits.size())
-            {
-                // It is somewhat more performant to have the smaller number on the right.
-                return multiply(y, x);
-            }
-            const bool is_negative = x.is_negative xor y.is_negative;
-            x.is_negative = y.is_negative = false;
-            integer result = zero;
-            // Multiply x with each digit of y, shifting according to the position of the digit.
-            for(int i = 0; i < y.digits.size(); i++)
+            if(amount <= 0)
             {
-                integer product_by_digit = multiply_integer_by_digit(x, y.digits[i]);
-                result = add(result, shift_left(product_by_digit, i));
+                return x;
             }
-            result.is_negative = is_negative;
-            return result;
+            x.digits = std::move(x.digits).drop(amount);
+            return x;
         }
-        // Divide two integers (returns <result, remainder>).
-        static std::pair<integer, integer> divide(integer x, integer y)
+        // Shift left by a number of bits (multiply by 2^bits). The whole digits are shifted structurally, the rest in a single pass.
+        static integer shift_bits_left(const integer& x, const std::size_t bits)
         {
-            if(is_equal_to(y, zero))
-            {
-                throw std::logic_error("Division by 0 impermissible.");
-            }
-            if(is_less_than(x, y))
-            {
-                return {zero, x};
-            }
-            const bool is_negative = x.is_negative xor y.is_negative;
-            x.is_negative = y.is_negative = false;
-            // Long division.
-            integer carry = zero;
-            integer result = zero;
-            for(int i = static_cast<int>(x.digits.size() - 1); i >= 0; i--)
+            const int bit_shift = static_cast<int>(bits % 32);
+            integer result = x;
+            if(bit_shift != 0 and !x.digits.empty())
             {
-                carry.digits = carry.digits.push_front(get_digit(x, i));
-                digit new_digit = small_divide(carry, y);
-                if(!result.digits.empty() or new_digit != 0)
+                digit_buffer shifted(x.digits.size() + 1);
+                std::size_t position = 0;
+                digit previous = 0;
+                immer::for_each_chunk(x.digits, [&](const digit* first, const digit* last)
                 {
-                    result.digits = result.digits.push_front(new_digit);
-                }
-                carry = subtract(carry, multiply_integer_by_digit(y, new_digit));
+                    const std::size_t size = last - first;
+                    funnel_shift_left(shifted.data() + position, first, size, bit_shift, previous);
+                    position += size;
+                    previous = *(last - 1);
+                });
+                shifted[position] = previous >> (32 - bit_shift);
+                trim(shifted);
+                result.digits = digits_from_buffer(shifted);
             }
-            result.is_negative = carry.is_negative = is_negative;
-            return {result, carry};
+            return shift_left(result, static_cast<int>(bits / 32));
         }
-        // Is x less than y? (strict indicates strict inequality).
-        static bool is_less_than(const integer& x, const integer& y, const bool strict = true)
+        // Shift right by a number of bits (divide by 2^bits, rounding down, so negative values round towards minus infinity).
+        static integer shift_bits_right(const integer& x, const std::size_t bits)
         {
-            // If both are zero.
-            if(is_equal_to(x, zero) and is_equal_to(y, zero))
-            {
-                return false;
-            }
-            // If unequal signs.
-            if(x.is_negative != y.is_negative)
+            const std::size_t whole_digits = bits / 32;
+            const int bit_shift = static_cast<int>(bits % 32);
+            if(whole_digits >= x.digits.size())
             {
-                return x.is_negative;
+                return x.is_negative and !x.digits.empty() ? negate(one) : zero;
             }
-            // If both negative.
-            if(x.is_negative and y.is_negative)
+            // For negative values, whether any of the bits shifted out is set (the magnitude is then rounded up).
+            bool is_inexact = false;
+            if(x.is_negative)
             {
-                return !is_less_than(negate(y), negate(x));
+                is_inexact = (x.digits[whole_digits] & ((digit(1) << bit_shift) - 1)) != 0;
+                if(!is_inexact and whole_digits != 0)
+                {
+                    is_inexact = !immer::for_each_chunk_p(x.digits.take(whole_digits), [](const digit* first, const digit* last)
+                    {
+                        return std::all_of(first, last, [](const digit d) { return d == 0; });
+                    });
+                }
             }
-
-            // Compare digits one by one.
-            if(x.digits.size() != y.digits.size())
+            integer result = create(x.digits.drop(whole_digits), x.is_negative);
+            if(bit_shift != 0)
             {
-                return x.digits.size() < y.digits.size();
+                digit_buffer shifted(result.digits.size());
+                std::size_t position = 0;
+                immer::for_each_chunk(result.digits, [&](const digit* first, const digit* last)
+                {
+                    const std::size_t size = last - first;
+                    // The last digit of the previous chunk waits for the first digit of this one.
+                    if(position != 0)
+                    {
+                        shifted[position - 1] |= first[0] << (32 - bit_shift);
+                    }
+                    funnel_shift_right(shifted.data() + position, first, size, bit_shift, 0);
+                    position += size;
+                });
+                trim(shifted);
+                result.digits = digits_from_buffer(shifted);
             }
-            for(int i = static_cast<int>(x.digits.size() - 1); i >= 0; i--)
+            if(is_inexact)
             {
-                if(get_digit(x, i) != get_digit(y, i))
-                {
-                    return get_digit(x, i) < get_digit(y, i);
-                }
+                result = negate(add_magnitude_word(negate(result), 1));
             }
-            return !strict;
+            return result;
         }
-        // Are x and y equal?
-        static bool is_equal_to(const integer& x, const integer& y)
+        // Bitwise AND, with negative values taken as infinite two's complement (so the result is negative only if both are).
+        static integer bitwise_and(const integer& x, const integer& y)
         {
-            if(x.digits.empty() and y.digits.empty())
-            {
-                return true; // Both zero (if a negative zero arises, treat it the same as positive).
-            }
-            return x.is_negative == y.is_negative and x.digits == y.digits;
+            return bitwise(x, y, [](const digit a, const digit b) { return a & b; });
         }
-
-        // Operator functions.
-        // Comparison.
-        friend bool operator==(const integer& x, const integer& y)
+        // Bitwise OR, with negative values taken as infinite two's complement.
+        static integer bitwise_or(const integer& x, const integer& y)
         {
-            return is_equal_to(x, y);
+            return bitwise(x, y, [](const digit a, const digit b) { return a | b; });
         }
-        friend bool operator!=(const integer& x, const integer& y)
+        // Bitwise XOR, with negative values taken as infinite two's complement.
+        static integer bitwise_xor(const integer& x, const integer& y)
         {
-            return !is_equal_to(x, y);
+            return bitwise(x, y, [](const digit a, const digit b) { return a ^ b; });
         }
-        friend bool operator<(const integer& x, const integer& y)
+        // Bitwise AND of x with the complement of y (clears the bits of x that are set in y).
+        static integer and_not(const integer& x, const integer& y)
         {
-            return is_less_than(x, y);
+            return bitwise(x, y, [](const digit a, const digit b) { return a & ~b; });
         }
-        friend bool operator<=(const integer& x, const integer& y)
+        // Bitwise NOT, which in two's complement is -x - 1.
+        static integer bitwise_not(const integer& x)
         {
-            return is_less_than(x, y);
+            return subtract(negate(x), one);
         }
-        friend bool operator>(const integer& x, const integer& y)
+        // Returned by find_next_set_bit when there is no set bit left.
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+        // Number of bits in |x| (0 for 0).
+        static std::size_t bit_length(const integer& x)
         {
-            return is_less_than(x, y);
+            if(x.digits.empty())
+            {
+                return 0;
+            }
+            return 32 * x.digits.size() - leading_zeros(x.digits.back());
         }
-        friend bool operator>=(const integer& x, const integer& y)
+        // Number of set bits in |x| (the two's complement of a negative value has infinitely many).
+        static std::size_t popcount(const integer& x)
         {
-            return is_less_than(x, y);
+            std::size_t count = 0;
+            immer::for_each_chunk(x.digits, [&count](const digit* first, const digit* last)
+            {
+                for(; first != last; ++first)
+                {
+                    count += population_count(*first);
+                }
+            });
+            return count;
         }
-        // Arithmetic.
-        friend integer operator+(const integer& x, const integer& y)
+        // Number of trailing zero bits, which is the same for x and -x.
+        static std::size_t count_trailing_zeros(const integer& x)
         {
-            return add(x, y);
+            if(x.digits.empty())
+            {
+                throw std::logic_error("Trailing zeros of 0 undefined.");
+            }
+            std::size_t count = 0;
+            immer::for_each_chunk_p(x.digits, [&count](const digit* first, const digit* last)
+            {
+                for(; first != last; ++first)
+                {
+                    if(*first != 0)
+                    {
+                        count += trailing_zeros(*first);
+                        return false;
+                    }
+                    count += 32;
+                }
+                return true;
+            });
+            return count;
         }
-        friend integer operator+(const integer& x)
+        // Is the bit at 'index' set (negative values taken as infinite two's complement)?
+        static bool test_bit(const integer& x, const std::size_t index)
         {
-            return x;
+            const std::size_t position = index / 32;
+            const bool is_set = position < x.digits.size() and (x.digits[position] >> (index % 32) & 1) != 0;
+            if(!x.is_negative or x.digits.empty())
+            {
+                return is_set;
+            }
+            // -m is ~(m - 1), which agrees with m up to its lowest set bit and is the complement of m above it.
+            return index <= count_trailing_zeros(x) ? is_set : !is_set;
         }
-        friend integer& operator+=(integer& x, const integer& y)
+        // Set the bit at 'index'.
+        static integer set_bit(const integer& x, const std::size_t index)
         {
-            x = add(x, y);
-            return x;
+            return test_bit(x, index) ? x : flip_bit(x, index);
         }
-        friend integer& operator++(integer& x)
+        // Clear the bit at 'index'.
+        static integer clear_bit(const integer& x, const std::size_t index)
         {
-            x = add(x, one);
-            return x;
+            return test_bit(x, index) ? flip_bit(x, index) : x;
         }
-        friend integer operator++(integer& x, int)
+        // Flip the bit at 'index'. Only the digit holding the bit is updated, the rest stay shared.
+        static integer flip_bit(const integer& x, const std::size_t index)
         {
-            integer old = x;
+            if(!x.is_negative or x.digits.empty())
+            {
+                return flip_magnitude_bit(absolute_value(x), index);
+            }
+            // Above the lowest set bit, the bits of -m are the complement of those of m.
+            if(index > count_trailing_zeros(x))
+            {
+                return flip_magnitude_bit(x, index);
+            }
+            return bitwise_xor(x, shift_bits_left(one, index));
+        }
+        // Index of the lowest set bit at or above 'start' (negative values taken as infinite two's complement), or npos if there is none.
+        static std::size_t find_next_set_bit(const integer& x, const std::size_t start)
+        {
+            if(!x.is_negative or x.digits.empty())
+            {
+                return find_bit(x.digits, start, 0);
+            }
+            // Below its lowest set bit, -m agrees with m, and above it, the set bits of -m are the clear bits of m.
+            const std::size_t lowest = count_trailing_zeros(x);
+            return start <= lowest ? lowest : find_bit(x.digits, start, max_digit);
+        }
+        // Is x a (positive) power of two?
+        static bool is_power_of_two(const integer& x)
+        {
+            return !x.is_negative and !x.digits.empty() and count_trailing_zeros(x) + 1 == bit_length(x);
+        }
+        // Multiply two integers, the algorithm being picked by the operand sizes.
+        static integer multiply(const integer& x, const integer& y)
+        {
+            const digit_buffer product = multiply_buffers(buffer_from_digits(x.digits), buffer_from_digits(y.digits));
+            return create(digits_from_buffer(product), (x.is_negative xor y.is_negative) and !product.empty());
+        }
+        // Divide two integers (returns <result, remainder>).
+        static std::pair<integer, integer> divide(integer x, integer y)
+        {
+            if(is_equal_to(y, zero))
+            {
+                throw std::logic_error("Division by 0 impermissible.");
+            }
+            // The quotient is truncated, so the remainder takes the sign of x.
+            if(is_less_than(absolute_value(x), absolute_value(y)))
+            {
+                return {zero, x};
+            }
+            const bool is_negative = x.is_negative xor y.is_negative;
+            // Divide the magnitudes, the algorithm being picked by the operand sizes.
+            digit_buffer quotient, remainder;
+            divide_buffers(quotient, remainder, buffer_from_digits(x.digits), buffer_from_digits(y.digits));
+            return {create(digits_from_buffer(quotient), is_negative),
+                    create(digits_from_buffer(remainder), x.is_negative and !remainder.empty())};
+        }
+        // Divide by a precomputed reciprocal (returns <result, remainder>), skipping the inversion of the divisor.
+        static std::pair<integer, integer> divide(const integer& x, const reciprocal& y)
+        {
+            const integer divisor = y.divisor();
+            if(is_less_than(absolute_value(x), absolute_value(divisor)))
+            {
+                return {zero, x};
+            }
+            if(y.inverse.empty())
+            {
+                return divide(x, divisor);
+            }
+            const bool is_negative = x.is_negative xor divisor.is_negative;
+            digit_buffer quotient, remainder;
+            newton_divide(quotient, remainder, buffer_from_digits(x.digits), y.normalized_divisor, y.inverse, y.shift);
+            return {create(digits_from_buffer(quotient), is_negative),
+                    create(digits_from_buffer(remainder), x.is_negative and !remainder.empty())};
+        }
+        // Divide x by y when y is known to divide x exactly (checked by an assertion in debug builds). This skips the remainder and uses
+        // Hensel (right-to-left) division, which is cheaper than long division.
+        static integer divide_exact(const integer& x, const integer& y)
+        {
+            if(is_equal_to(y, zero))
+            {
+                throw std::logic_error("Division by 0 impermissible.");
+            }
+            const digit_buffer dividend = buffer_from_digits(x.digits), divisor = buffer_from_digits(y.digits);
+            const digit_buffer quotient = divide_exact_buffers(dividend, divisor);
+            assert(multiply_buffers(quotient, divisor) == dividend and "divide_exact needs y to divide x.");
+            return create(digits_from_buffer(quotient), (x.is_negative xor y.is_negative) and !quotient.empty());
+        }
+        // Divide by a native word (returns <result, remainder>). The remainder is that of the absolute value of x.
+        static std::pair<integer, superdigit> divide(const integer& x, const superdigit y)
+        {
+            if(y == 0)
+            {
+                throw std::logic_error("Division by 0 impermissible.");
+            }
+            // Each quotient word is written into its pair of digits, from the top.
+            digit_buffer quotient(2 * ((x.digits.size() + 1) / 2 + 1));
+            std::size_t position = quotient.size();
+            const superdigit remainder = divide_by_word(x.digits, y, [&quotient, &position](const superdigit word)
+            {
+                quotient[--position] = static_cast<digit>(word >> 32);
+                quotient[--position] = static_cast<digit>(word);
+            });
+            trim(quotient);
+            return {create(digits_from_buffer(quotient), x.is_negative and !quotient.empty()), remainder};
+        }
+        // Remainder of the absolute value of x divided by a native word. Allocates nothing.
+        static superdigit remainder(const integer& x, const superdigit y)
+        {
+            if(y == 0)
+            {
+                throw std::logic_error("Division by 0 impermissible.");
+            }
+            return divide_by_word(x.digits, y, [](superdigit) {});
+        }
+        // Signed and 128-bit native divisors would be converted to a word (-5 becoming 2^64 - 5), so they are rejected. Divide by
+        // integer(y), or use / and %, which take the sign into account.
+        template<typename T, typename = std::enable_if_t<is_native_integer<T> and (static_cast<T>(-1) < static_cast<T>(0) or sizeof(T) > sizeof(superdigit))>>
+        static std::pair<integer, superdigit> divide(const integer& x, const T y) = delete;
+        template<typename T, typename = std::enable_if_t<is_native_integer<T> and (static_cast<T>(-1) < static_cast<T>(0) or sizeof(T) > sizeof(superdigit))>>
+        static superdigit remainder(const integer& x, const T y) = delete;
+        // Greatest common divisor of |x| and |y| (0 if both are 0).
+        static integer gcd(const integer& x, const integer& y)
+        {
+            digit_buffer result = gcd_buffers(buffer_from_digits(x.digits), buffer_from_digits(y.digits));
+            trim(result);
+            return create(digits_from_buffer(result), false);
+        }
+        // The continued fraction of x / y: x / y rounded down, followed by the quotients of Euclid's algorithm on y and the rest (which
+        // are positive, the last one above 1).
+        static std::vector<integer> continued_fraction(const integer& x, const integer& y)
+        {
+            if(is_equal_to(y, zero))
+            {
+                throw std::logic_error("Division by 0 impermissible.");
+            }
+            const integer denominator = absolute_value(y);
+            auto [quotient, remainder] = divide(y.is_negative ? negate(x) : x, denominator);
+            if(remainder.is_negative and !remainder.digits.empty())
+            {
+                quotient = quotient - 1;
+                remainder = remainder + denominator;
+            }
+            std::vector<integer> result{quotient};
+            if(remainder.digits.empty())
+            {
+                return result;
+            }
+            digit_buffer first = buffer_from_digits(denominator.digits), second = buffer_from_digits(remainder.digits);
+            std::vector<digit_buffer> quotients;
+            gcd_quotients(first, second, nullptr, &quotients);
+            for(const digit_buffer& q : quotients)
+            {
+                result.push_back(create(digits_from_buffer(q), false));
+            }
+            return result;
+        }
+        // The greatest common divisor g of |x| and |y| with cofactors (s, t) such that s x + t y = g, as Euclid's algorithm leaves them
+        // (so |s| is at most |y| / 2g and |t| at most |x| / 2g, unless one of x and y divides the other).
+        static std::tuple<integer, integer, integer> extended_gcd(const integer& x, const integer& y)
+        {
+            digit_buffer first = buffer_from_digits(x.digits), second = buffer_from_digits(y.digits);
+            const bool is_swapped = compare_buffers(first.data(), first.size(), second.data(), second.size()) < 0;
+            if(is_swapped)
+            {
+                std::swap(first, second);
+            }
+            const integer& larger = is_swapped ? y : x;
+            const integer& smaller = is_swapped ? x : y;
+            integer g, s, t;
+            if(second.empty())
+            {
+                g = absolute_value(larger);
+                s = larger.digits.empty() ? zero : larger.is_negative ? negate(one) : one;
+            }
+            else
+            {
+                // The cofactor of the smaller value is tracked, and that of the larger one recovered by an exact division.
+                digit_buffer cofactor;
+                bool is_negative = false;
+                const digit_buffer result = gcd_cofactor(first, second, cofactor, is_negative);
+                // s |larger| = g - t |smaller|, where t |smaller| is at least g unless t is not positive.
+                const digit_buffer product = multiply_buffers(cofactor, second);
+                const bool is_below = !is_negative and compare_buffers(product.data(), product.size(), result.data(), result.size()) > 0;
+                const digit_buffer numerator = is_negative ? add_buffers(result, product)
+                                                           : is_below ? subtract_buffers(product, result) : subtract_buffers(result, product);
+                const digit_buffer other = divide_exact_buffers(numerator, first);
+                g = create(digits_from_buffer(result), false);
+                s = create(digits_from_buffer(other), (is_below xor larger.is_negative) and !other.empty());
+                t = create(digits_from_buffer(cofactor), (is_negative xor smaller.is_negative) and !cofactor.empty());
+            }
+            if(is_swapped)
+            {
+                std::swap(s, t);
+            }
+            return {g, s, t};
+        }
+        // The inverse of x modulo m (whose sign is ignored), in [0, |m|), or nothing if x and m are not coprime.
+        static std::optional<integer> mod_inverse(const integer& x, const integer& m)
+        {
+            if(is_equal_to(m, zero))
+            {
+                throw std::logic_error("Division by 0 impermissible.");
+            }
+            const digit_buffer modulus = buffer_from_digits(m.digits);
+            if(modulus == digit_buffer{1})
+            {
+                return zero;
+            }
+            digit_buffer quotient, value;
+            divide_buffers(quotient, value, buffer_from_digits(x.digits), modulus);
+            if(x.is_negative and !value.empty())
+            {
+                value = subtract_buffers(modulus, value);
+            }
+            // Odd moduli of a word are inverted by the binary algorithm, with shifts and subtractions only.
+            if(modulus.size() <= 2 and modulus[0] % 2 != 0)
+            {
+                superdigit inverse = 0;
+                if(!binary_inverse(buffer_bits(value, 0, 64), buffer_bits(modulus, 0, 64), inverse))
+                {
+                    return std::nullopt;
+                }
+                return integer(inverse);
+            }
+            if(value.empty())
+            {
+                return std::nullopt;
+            }
+            digit_buffer cofactor;
+            bool is_negative = false;
+            if(gcd_cofactor(modulus, value, cofactor, is_negative) != digit_buffer{1})
+            {
+                return std::nullopt;
+            }
+            if(is_negative and !cofactor.empty())
+            {
+                cofactor = subtract_buffers(modulus, cofactor);
+            }
+            return create(digits_from_buffer(cofactor), false);
+        }
+        // base^exponent mod m (whose sign is ignored), in [0, |m|), for a non-negative exponent: in Montgomery form for odd moduli,
+        // with Barrett reduction otherwise.
+        static integer powmod(const integer& base, const integer& exponent, const integer& m)
+        {
+            if(is_equal_to(m, zero))
+            {
+                throw std::logic_error("Division by 0 impermissible.");
+            }
+            if(m.digits[0] % 2 != 0)
+            {
+                return montgomery_context::create(m).powmod(base, exponent);
+            }
+            return barrett_context::create(m).powmod(base, exponent);
+        }
+        // Is x less than y? (strict indicates strict inequality).
+        static bool is_less_than(const integer& x, const integer& y, const bool strict = true)
+        {
+            // If both are zero.
+            if(is_equal_to(x, zero) and is_equal_to(y, zero))
+            {
+                return !strict;
+            }
+            // If unequal signs.
+            if(x.is_negative != y.is_negative)
+            {
+                return x.is_negative;
+            }
+            // If both negative.
+            if(x.is_negative and y.is_negative)
+            {
+                return is_less_than(negate(y), negate(x), strict);
+            }
+
+            // Compare digits one by one.
+            if(x.digits.size() != y.digits.size())
+            {
+                return x.digits.size() < y.digits.size();
+            }
+            for(int i = static_cast<int>(x.digits.size() - 1); i >= 0; i--)
+            {
+                if(get_digit(x, i) != get_digit(y, i))
+                {
+                    return get_digit(x, i) < get_digit(y, i);
+                }
+            }
+            return !strict;
+        }
+        // Are x and y equal?
+        static bool is_equal_to(const integer& x, const integer& y)
+        {
+            if(x.digits.empty() and y.digits.empty())
+            {
+                return true; // Both zero (if a negative zero arises, treat it the same as positive).
+            }
+            return x.is_negative == y.is_negative and x.digits == y.digits;
+        }
+
+        // Operator functions.
+        // Comparison.
+        friend bool operator==(const integer& x, const integer& y)
+        {
+            return is_equal_to(x, y);
+        }
+        friend bool operator!=(const integer& x, const integer& y)
+        {
+            return !is_equal_to(x, y);
+        }
+        friend bool operator<(const integer& x, const integer& y)
+        {
+            return is_less_than(x, y);
+        }
+        friend bool operator<=(const integer& x, const integer& y)
+        {
+            return is_less_than(x, y, false);
+        }
+        friend bool operator>(const integer& x, const integer& y)
+        {
+            return is_less_than(y, x);
+        }
+        friend bool operator>=(const integer& x, const integer& y)
+        {
+            return is_less_than(y, x, false);
+        }
+        // Arithmetic.
+        friend integer operator+(const integer& x, const integer& y)
+        {
+            return add(x, y);
+        }
+        friend integer operator+(const integer& x)
+        {
+            return x;
+        }
+        friend integer& operator+=(integer& x, const integer& y)
+        {
+            x = add(x, y);
+            return x;
+        }
+        friend integer& operator++(integer& x)
+        {
+            x = add(x, one);
+            return x;
+        }
+        friend integer operator++(integer& x, int)
+        {
+            integer old = x;
             x = add(x, one);
             return old;
         }
@@ -355,171 +1193,3573 @@ namespace int_titan
             x = divide(x, y).second;
             return x;
         }
-    private:
-        // A vector of base-2^32 digits (little-endian).
-        integer_digits digits;
-        // Is the integer negative?
-        bool is_negative = false;
-        // Get a digit from an integer.
-        static digit get_digit(const integer& x, const int index)
+        // Bit shifts.
+        friend integer operator<<(const integer& x, const std::size_t bits)
         {
-            // Return the digit's value if present, else return 0 as a leading zero.
-            return index < x.digits.size() ? x.digits[index] : 0;
+            return shift_bits_left(x, bits);
         }
-        // Get an inverse digit of a digit (the one with which it adds up to 10 base 2^32).
-        static digit inverse_digit(const digit digit)
+        friend integer& operator<<=(integer& x, const std::size_t bits)
         {
-            assert(digit != 0); // 0 does not have an inverse.
-            return static_cast<superdigit>(max_digit) + 1 - digit;
+            x = shift_bits_left(x, bits);
+            return x;
         }
-        // Get value of a digit character (e.g. value of '0' is 0, value of 'D' is 13).
-        static int get_digit_character_value(char d)
+        friend integer operator>>(const integer& x, const std::size_t bits)
         {
-            d = static_cast<char>(std::tolower(d));
-            assert((d >= '0' and d <= '9') or (d >= 'a' and d <= 'z'));
-            if(d >= '0' and d <= '9')
-            {
-                return d - '0';
-            }
-            return 10 + d - 'a';
+            return shift_bits_right(x, bits);
         }
-        // Get digit character for value.
-        static char get_digit_character(const int value, const bool uppercase = true)
+        friend integer& operator>>=(integer& x, const std::size_t bits)
         {
-            assert(value < (1 + '9' - '0') + (1 + 'Z' - 'A'));
-            if(value < 10)
-            {
-                return static_cast<char>('0' + value);
-            }
-            char a = uppercase ? 'A' : 'a';
-            return static_cast<char>(a + value - 10);
+            x = shift_bits_right(x, bits);
+            return x;
         }
-        // Read integers from strings (decimal and hex).
-        static integer_digits digits_from_string(const std::string_view str, const bool is_hex)
+        // Bitwise operators.
+        friend integer operator&(const integer& x, const integer& y)
         {
-            // Only hex is currently supported.
-            assert(is_hex);
-            if(is_hex)
-            {
-                return digits_from_hex_string(str);
-            }
-            throw std::exception();
+            return bitwise_and(x, y);
         }
-        // Convert integers to strings (decimal and hex).
-        static std::string string_from_integer(const integer& x, const bool is_hex = true, const bool uppercase = true)
+        friend integer& operator&=(integer& x, const integer& y)
         {
-            // Only hex is currently supported.
-            assert(is_hex);
-            if(is_hex)
-            {
-                return hex_string_from_integer(x, uppercase);
-            }
-            throw std::exception();
+            x = bitwise_and(x, y);
+            return x;
         }
-        // Read integers from hex strings.
-        static integer_digits digits_from_hex_string(const std::string_view str)
+        friend integer operator|(const integer& x, const integer& y)
         {
-            const int bits_per_hex_digit = 4; // How many bits are contained in a hex digit.
-            const int characters_per_digit = 32 / bits_per_hex_digit; // How many hex digits in str fill up a base-2^32 digit.
-            auto result = integer_digits().transient();
-            digit current_digit = 0;
-            for(int counter = 0, i = static_cast<int>(str.size() - 1); i >= 0; i--)
-            {
-                const int current_character = get_digit_character_value(str[i]);
-                current_digit |= (current_character << (bits_per_hex_digit * counter));
-                if ((++counter %= characters_per_digit) == 0)
-                {
-                    result.push_back(current_digit);
-                    current_digit = 0;
-                }
-            }
-            if(current_digit != 0)
-            {
-                result.push_back(current_digit);
-            }
-            return result.persistent();
+            return bitwise_or(x, y);
         }
-        // Convert integers to hex strings.
-        static std::string hex_string_from_integer(const integer& x, const bool uppercase = true)
+        friend integer& operator|=(integer& x, const integer& y)
         {
-            const int bits_per_hex_digit = 4; // How many bits are contained in a hex digit.
-            std::stringstream ss;
-            if(x.is_negative)
-            {
-                ss << '-';
-            }
-            const auto& digits = x.digits;
-            int current_bits = 0;
-            bool has_at_least_one_character = false; // Used to avoid leading zeroes.
-            // Reads the digits from the most significant to the least significant.
-            for(int counter = 0, i = static_cast<int>(digits.size() - 1); i >= 0; i--)
-            {
-                digit current_digit = digits[i];
-                // Reads individual bits from the most significant to the least significant.
-                for(int bit = 31; bit >= 0; bit--)
-                {
-                    bool is_set = !!(current_digit & (1 << bit));
-                    current_bits |= (is_set << (bits_per_hex_digit - 1 - (counter % bits_per_hex_digit)));
-                    if((++counter %= bits_per_hex_digit) == 0)
-                    {
-                        if(has_at_least_one_character or current_bits != 0)
-                        {
-                            ss << get_digit_character(current_bits, uppercase);
-                            has_at_least_one_character = true;
-                            current_bits = 0;
-                        }
-                    }
-                }
-            }
-            return ss.str();
+            x = bitwise_or(x, y);
+            return x;
         }
-        // Multiplication of base 2^32 digits.
-        static superdigit multiply_digits(const digit x, const digit y)
+        friend integer operator^(const integer& x, const integer& y)
         {
-            const superdigit p = static_cast<superdigit>(x) * static_cast<superdigit>(y);
-            return p;
+            return bitwise_xor(x, y);
         }
-        // Multiplication of an integer with a base 2^32 digit.
-        static integer multiply_integer_by_digit(const integer& x, const digit d)
+        friend integer& operator^=(integer& x, const integer& y)
         {
-            digit carry = 0;
-            auto result = integer_digits().transient();
-            for(int i = 0; i < x.digits.size(); i++)
-            {
-                const superdigit product = multiply_digits(get_digit(x, i), d) + carry;
-                result.push_back((product << 32) >> 32);
-                carry = (product >> 32);
-            }
-            if(carry != 0)
-            {
-                result.push_back(carry);
-            }
-            // Remove leading 0s.
-            while (!result.empty() and result[result.size() - 1] == 0)
-            {
-                result.take(result.size() - 1);
-            }
-            return create(result.persistent(), x.is_negative);
+            x = bitwise_xor(x, y);
+            return x;
         }
-        // Division of an integer with an integer that we know will result in a digit.
-        static digit small_divide(const integer& x, const integer& y)
+        friend integer operator~(const integer& x)
         {
-            // Common case, should be checked first.
-            if(is_less_than(x, y))
-            {
-                return 0;
+            return bitwise_not(x);
+        }
+        // Mixed operators with native integers. Values that fit a word go through single-word kernels, without a temporary integer.
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend bool operator==(const integer& x, const T y)
+        {
+            return compare_native(x, y) == 0;
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend bool operator==(const T x, const integer& y)
+        {
+            return 0 == compare_native(y, x);
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend bool operator!=(const integer& x, const T y)
+        {
+            return compare_native(x, y) != 0;
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend bool operator!=(const T x, const integer& y)
+        {
+            return 0 != compare_native(y, x);
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend bool operator<(const integer& x, const T y)
+        {
+            return compare_native(x, y) < 0;
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend bool operator<(const T x, const integer& y)
+        {
+            return 0 < compare_native(y, x);
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend bool operator<=(const integer& x, const T y)
+        {
+            return compare_native(x, y) <= 0;
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend bool operator<=(const T x, const integer& y)
+        {
+            return 0 <= compare_native(y, x);
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend bool operator>(const integer& x, const T y)
+        {
+            return compare_native(x, y) > 0;
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend bool operator>(const T x, const integer& y)
+        {
+            return 0 > compare_native(y, x);
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend bool operator>=(const integer& x, const T y)
+        {
+            return compare_native(x, y) >= 0;
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend bool operator>=(const T x, const integer& y)
+        {
+            return 0 >= compare_native(y, x);
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend integer operator+(const integer& x, const T y)
+        {
+            return native_fits_word(y) ? add_word(x, is_negative_native(y), native_magnitude_of(y)) : add(x, integer(y));
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend integer operator+(const T x, const integer& y)
+        {
+            return y + x;
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend integer& operator+=(integer& x, const T y)
+        {
+            x = x + y;
+            return x;
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend integer operator-(const integer& x, const T y)
+        {
+            return native_fits_word(y) ? add_word(x, !is_negative_native(y), native_magnitude_of(y)) : subtract(x, integer(y));
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend integer operator-(const T x, const integer& y)
+        {
+            // x - y = -(y - x), which is 0 rather than a negative zero when they are equal.
+            const integer difference = y - x;
+            return difference.digits.empty() ? zero : negate(difference);
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend integer& operator-=(integer& x, const T y)
+        {
+            x = x - y;
+            return x;
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend integer operator*(const integer& x, const T y)
+        {
+            return native_fits_word(y) ? multiply_word(x, is_negative_native(y), native_magnitude_of(y)) : multiply(x, integer(y));
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend integer operator*(const T x, const integer& y)
+        {
+            return y * x;
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend integer& operator*=(integer& x, const T y)
+        {
+            x = x * y;
+            return x;
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend integer operator/(const integer& x, const T y)
+        {
+            if(!native_fits_word(y))
+            {
+                return divide(x, integer(y)).first;
+            }
+            integer quotient = divide(x, static_cast<superdigit>(native_magnitude_of(y))).first;
+            quotient.is_negative = !quotient.digits.empty() and (x.is_negative xor is_negative_native(y));
+            return quotient;
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend integer& operator/=(integer& x, const T y)
+        {
+            x = x / y;
+            return x;
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend integer operator%(const integer& x, const T y)
+        {
+            if(!native_fits_word(y))
+            {
+                return divide(x, integer(y)).second;
+            }
+            const superdigit magnitude = remainder(x, static_cast<superdigit>(native_magnitude_of(y)));
+            return create(digits_from_word(magnitude), x.is_negative and magnitude != 0);
+        }
+        template<typename T, typename = std::enable_if_t<is_native_integer<T>>>
+        friend integer& operator%=(integer& x, const T y)
+        {
+            x = x % y;
+            return x;
+        }
+    private:
+        // A vector of base-2^32 digits (little-endian).
+        integer_digits digits;
+        // Is the integer negative?
+        bool is_negative = false;
+        // The widest native magnitude: that of the 128-bit types where the compiler has them.
+#if defined(__SIZEOF_INT128__)
+        using native_magnitude = unsigned __int128;
+#else
+        using native_magnitude = superdigit;
+#endif
+        template<typename T>
+        static constexpr bool is_signed_native = static_cast<T>(-1) < static_cast<T>(0);
+        template<typename T>
+        static bool is_negative_native(const T value)
+        {
+            if constexpr(is_signed_native<T>)
+            {
+                return value < 0;
+            }
+            return false;
+        }
+        // |value| (which is also right for the most negative value of a signed type).
+        template<typename T>
+        static native_magnitude native_magnitude_of(const T value)
+        {
+            const native_magnitude magnitude = static_cast<native_magnitude>(value);
+            return is_negative_native(value) ? -magnitude : magnitude;
+        }
+        // Does |value| fit a word? It always does, but for the 128-bit types.
+        template<typename T>
+        static bool native_fits_word(const T value)
+        {
+            if constexpr(sizeof(T) <= sizeof(superdigit))
+            {
+                return true;
+            }
+            else
+            {
+                return native_magnitude_of(value) >> 64 == 0;
+            }
+        }
+        template<typename T>
+        static integer_digits digits_from_native(const T value)
+        {
+            auto result = integer_digits().transient();
+            for(native_magnitude magnitude = native_magnitude_of(value); magnitude != 0; magnitude = magnitude >> 16 >> 16)
+            {
+                result.push_back(static_cast<digit>(magnitude));
+            }
+            return result.persistent();
+        }
+        // The bits of |x| from bit 'start', at least 'count' of them (which must fit a native magnitude) but possibly more from the digit
+        // the last one is in, so that callers mask them unless the bits above are clear.
+        static native_magnitude magnitude_bits(const integer& x, const std::size_t start, const std::size_t count)
+        {
+            native_magnitude result = 0;
+            for(std::size_t i = start / 32; i < x.digits.size() and 32 * i < start + count; i++)
+            {
+                const digit d = x.digits[i];
+                result |= 32 * i < start ? d >> (start - 32 * i) : static_cast<native_magnitude>(d) << (32 * i - start);
+            }
+            return result;
+        }
+        template<typename F>
+        static F to_floating(const integer& x)
+        {
+            constexpr int precision = std::numeric_limits<F>::digits;
+            const std::size_t length = bit_length(x);
+            const F sign = x.is_negative ? -1 : 1;
+            if(length > static_cast<std::size_t>(std::numeric_limits<F>::max_exponent))
+            {
+                return sign * std::numeric_limits<F>::infinity();
+            }
+            // The top bits of |x|, as many as the mantissa holds, read 64 at a time (so that they do not have to fit a native magnitude,
+            // which is only 64 bits without the 128-bit types). Every partial sum is exact in F.
+            const std::size_t low = length > precision ? length - precision : 0;
+            F mantissa = 0;
+            for(std::size_t end = length; end > low;)
+            {
+                const std::size_t count = std::min<std::size_t>(64, end - low);
+                end -= count;
+                const superdigit bits = static_cast<superdigit>(magnitude_bits(x, end, count));
+                mantissa = std::ldexp(mantissa, static_cast<int>(count)) + static_cast<F>(count == 64 ? bits : bits & ((superdigit(1) << count) - 1));
+            }
+            // Round to nearest, ties to even: the bit below the mantissa decides, the rest only mattering as a sticky bit for ties.
+            const auto bit = [&x](const std::size_t position)
+            {
+                return (magnitude_bits(x, position, 1) & 1) != 0;
+            };
+            if(low != 0 and bit(low - 1) and (bit(low) or count_trailing_zeros(x) < low - 1))
+            {
+                mantissa += 1;
+            }
+            return sign * std::ldexp(mantissa, static_cast<int>(low));
+        }
+        // floor(n log10 2), with the fraction of n log10 2 in 64-bit fixed point (at most 2^-63 below the actual one), from a 128-bit
+        // fixed-point log10 2.
+        static superdigit log10_of_power_of_two(const superdigit n, superdigit& fraction)
+        {
+            constexpr superdigit log10_2_high = 0x4d104d427de7fbcc, log10_2_low = 0x47c4acd605be48bc;
+            superdigit carry, high;
+            multiply_add_words(n, log10_2_low, 0, 0, carry);
+            fraction = multiply_add_words(n, log10_2_high, carry, 0, high);
+            return high;
+        }
+        // floor(log10 |x|) for an x of more than 64 bits, along with the fraction of log10 |x|. Between 2^(length - 1) and 2^length
+        // there is at most one power of ten, and x is placed with respect to it by the log10 of its top 64 bits, or by comparing with
+        // the power itself when that is too close to call.
+        static std::size_t decimal_exponent(const integer& x, const std::size_t length, long double& fraction)
+        {
+            superdigit low_fraction;
+            const std::size_t exponent = log10_of_power_of_two(length - 1, low_fraction);
+            // |x| / 2^(length - 1) and its log10, which is in [0, log10 2).
+            const long double mantissa = std::ldexp(static_cast<long double>(static_cast<superdigit>(magnitude_bits(x, length - 64, 64))), -63);
+            const long double log_mantissa = std::log10(mantissa);
+            fraction = std::ldexp(static_cast<long double>(low_fraction), -64) + log_mantissa;
+            const long double margin = 32 * std::numeric_limits<long double>::epsilon();
+            bool is_above;
+            if(std::fabs(fraction - 1) > margin)
+            {
+                is_above = fraction > 1;
+            }
+            else
+            {
+                const digit_buffer power = power_of_ten(exponent + 1), magnitude = buffer_from_digits(x.digits);
+                is_above = compare_buffers(magnitude.data(), magnitude.size(), power.data(), power.size()) >= 0;
+            }
+            if(is_above)
+            {
+                fraction = std::max(fraction - 1, 0.0L);
+                return exponent + 1;
+            }
+            fraction = std::min(fraction, 1 - std::numeric_limits<long double>::epsilon());
+            return exponent;
+        }
+        // The leading 'count' decimal digits of |x|, of 'digit_count' digits, rounded (ties to even) exactly; a carry into a new
+        // digit gives one more.
+        static std::string leading_decimal_digits(const integer& x, const std::size_t digit_count, const std::size_t count)
+        {
+            if(digit_count <= count)
+            {
+                return string_from_integer(absolute_value(x), 10, false) + std::string(count - digit_count, '0');
+            }
+            const digit_buffer power = power_of_ten(digit_count - count);
+            digit_buffer quotient, remainder;
+            divide_buffers(quotient, remainder, buffer_from_digits(x.digits), power);
+            // Compare the remainder with half of the power.
+            const digit carry = shift_digits_left(remainder.data(), remainder.data(), remainder.size(), 1);
+            if(carry != 0)
+            {
+                remainder.push_back(carry);
+            }
+            const int comparison = compare_buffers(remainder.data(), remainder.size(), power.data(), power.size());
+            if(comparison > 0 or (comparison == 0 and !quotient.empty() and quotient[0] % 2 != 0))
+            {
+                quotient.push_back(0);
+                add_digits(quotient.data(), quotient.size(), digit_buffer{1}.data(), 1);
+                trim(quotient);
+            }
+            return string_from_integer(create(digits_from_buffer(quotient), false), 10, false);
+        }
+        template<typename F>
+        static integer from_floating(const F value)
+        {
+            if(!std::isfinite(value))
+            {
+                throw std::logic_error("Non-finite value impermissible.");
+            }
+            constexpr int precision = std::numeric_limits<F>::digits;
+            int exponent;
+            const F fraction = std::frexp(std::fabs(value), &exponent);
+            // The mantissa as an integer, and its place.
+            const native_magnitude mantissa = static_cast<native_magnitude>(std::ldexp(fraction, precision));
+            const int shift = exponent - precision;
+            integer result;
+            if(shift >= 0)
+            {
+                result = shift_bits_left(integer(mantissa), shift);
+            }
+            else if(-shift < precision)
+            {
+                result = integer(mantissa >> -shift);
+            }
+            result.is_negative = value < 0 and !result.digits.empty();
+            return result;
+        }
+        // Compare x with a native integer (returns -1, 0 or 1).
+        template<typename T>
+        static int compare_native(const integer& x, const T y)
+        {
+            if(!native_fits_word(y))
+            {
+                return is_less_than(x, integer(y)) ? -1 : is_equal_to(x, integer(y)) ? 0 : 1;
+            }
+            const superdigit magnitude = static_cast<superdigit>(native_magnitude_of(y));
+            const bool x_negative = x.is_negative and !x.digits.empty(), y_negative = is_negative_native(y) and magnitude != 0;
+            if(x_negative != y_negative)
+            {
+                return x_negative ? -1 : 1;
+            }
+            int comparison = 1;
+            if(x.digits.size() <= 2)
+            {
+                const superdigit x_magnitude = word_from_digits(x.digits);
+                comparison = x_magnitude < magnitude ? -1 : x_magnitude == magnitude ? 0 : 1;
+            }
+            return x_negative ? -comparison : comparison;
+        }
+        // x plus a word with the given sign.
+        static integer add_word(const integer& x, const bool is_negative, const superdigit w)
+        {
+            if(x.digits.empty())
+            {
+                return create(digits_from_word(w), is_negative and w != 0);
+            }
+            if(x.is_negative == is_negative)
+            {
+                return add_magnitude_word(x, w);
+            }
+            // Opposite signs: the smaller magnitude is taken from the larger one.
+            if(x.digits.size() <= 2 and word_from_digits(x.digits) < w)
+            {
+                return create(digits_from_word(w - word_from_digits(x.digits)), is_negative);
+            }
+            return subtract_magnitude_word(x, w);
+        }
+        // x times a word with the given sign, in a single pass over the digits of x.
+        static integer multiply_word(const integer& x, const bool is_negative, const superdigit w)
+        {
+            if(x.digits.empty() or w == 0)
+            {
+                return zero;
+            }
+            digit_buffer product(x.digits.size() + 2);
+            std::size_t position = 0;
+            superdigit carry = 0;
+            immer::for_each_chunk(x.digits, [&](const digit* first, const digit* last)
+            {
+                for(; first != last; ++first)
+                {
+                    // The 96-bit product of a digit and the word, plus the carry, cannot overflow two words.
+                    superdigit high;
+                    const superdigit low = multiply_add_words(*first, w, carry, 0, high);
+                    product[position++] = static_cast<digit>(low);
+                    carry = (high << 32) | (low >> 32);
+                }
+            });
+            product[position] = static_cast<digit>(carry);
+            product[position + 1] = static_cast<digit>(carry >> 32);
+            trim(product);
+            return create(digits_from_buffer(product), x.is_negative xor is_negative);
+        }
+        // Get a digit from an integer.
+        static digit get_digit(const integer& x, const int index)
+        {
+            // Return the digit's value if present, else return 0 as a leading zero.
+            return index < x.digits.size() ? x.digits[index] : 0;
+        }
+        // Get value of a digit character (e.g. value of '0' is 0, value of 'D' is 13), which is 36 if it is not a digit in any radix.
+        static int get_digit_character_value(const char d)
+        {
+            if(d >= '0' and d <= '9')
+            {
+                return d - '0';
+            }
+            if(d >= 'a' and d <= 'z')
+            {
+                return 10 + d - 'a';
+            }
+            if(d >= 'A' and d <= 'Z')
+            {
+                return 10 + d - 'A';
+            }
+            return 36;
+        }
+        // Get digit character for value.
+        static char get_digit_character(const int value, const bool uppercase = true)
+        {
+            assert(value < (1 + '9' - '0') + (1 + 'Z' - 'A'));
+            if(value < 10)
+            {
+                return static_cast<char>('0' + value);
+            }
+            char a = uppercase ? 'A' : 'a';
+            return static_cast<char>(a + value - 10);
+        }
+        // Check that a radix is supported.
+        static void check_radix(const int radix)
+        {
+            if(radix < 2 or radix > 36)
+            {
+                throw std::logic_error("Radix outside of 2-36 impermissible.");
+            }
+        }
+        // Read integers from strings in a radix from 2 to 36.
+        static integer_digits digits_from_string(const std::string_view str, const int radix)
+        {
+            check_radix(radix);
+            if(radix == 16)
+            {
+                return digits_from_hex_string(str);
+            }
+            if((radix & (radix - 1)) == 0)
+            {
+                return digits_from_power_of_two_string(str, trailing_zeros(static_cast<digit>(radix)));
+            }
+            return digits_from_radix_string(str, radix);
+        }
+        // Convert integers to strings in a radix from 2 to 36.
+        static std::string string_from_integer(const integer& x, const int radix = 16, const bool uppercase = true)
+        {
+            check_radix(radix);
+            std::string result(max_chars(x, radix), '0');
+            result.resize(write_characters(result.data(), x, radix, uppercase) - result.data());
+            return result;
+        }
+        // Write x in a radix from 2 to 36 into a buffer of at least max_chars(x, radix) characters (returns the end of what was written).
+        static char* write_characters(char* str, const integer& x, const int radix, const bool uppercase)
+        {
+            if(x.digits.empty())
+            {
+                *str = '0';
+                return str + 1;
+            }
+            if(x.is_negative)
+            {
+                *str++ = '-';
+            }
+            if(radix == 16)
+            {
+                const std::size_t length = hex_length(x.digits);
+                write_hex(x.digits, str, length, uppercase);
+                return str + length;
+            }
+            if((radix & (radix - 1)) == 0)
+            {
+                const int bits = trailing_zeros(static_cast<digit>(radix));
+                const std::size_t length = (bit_length(x) + bits - 1) / bits;
+                write_power_of_two(x.digits, str, length, bits, uppercase);
+                return str + length;
+            }
+            return write_radix(x.digits, str, magnitude_max_chars(x.digits, radix), radix, uppercase);
+        }
+        // Upper bound on the number of characters of |x| in a radix, as each of them holds at least floor(log2(radix)) bits.
+        static std::size_t magnitude_max_chars(const integer_digits& digits, const int radix)
+        {
+            if(digits.empty())
+            {
+                return 1;
+            }
+            const std::size_t bits = 32 * digits.size() - leading_zeros(digits.back());
+            const std::size_t bits_per_character = 31 - leading_zeros(static_cast<digit>(radix));
+            return (bits + bits_per_character - 1) / bits_per_character;
+        }
+        // The value of at most two digits.
+        static superdigit word_from_digits(const integer_digits& digits)
+        {
+            assert(digits.size() <= 2);
+            return digits.empty() ? 0 : digits.size() == 1 ? digits[0] : (static_cast<superdigit>(digits[1]) << 32) | digits[0];
+        }
+        // The digits of a word.
+        static integer_digits digits_from_word(const superdigit w)
+        {
+            if(w >> 32 != 0)
+            {
+                return {static_cast<digit>(w), static_cast<digit>(w >> 32)};
+            }
+            return w != 0 ? integer_digits{static_cast<digit>(w)} : integer_digits();
+        }
+        // Write a word in a radix, backwards from 'last' (returns the first character written).
+        static char* write_word(superdigit w, char* last, const int radix, const bool uppercase)
+        {
+            do
+            {
+                *--last = get_digit_character(static_cast<int>(w % radix), uppercase);
+                w /= radix;
+            }
+            while(w != 0);
+            return last;
+        }
+        // Value of each character as a hex digit, or 0xFF if it is not one.
+        static constexpr std::array<unsigned char, 256> hex_character_values()
+        {
+            std::array<unsigned char, 256> values{};
+            for(int c = 0; c < 256; c++)
+            {
+                values[c] = c >= '0' and c <= '9' ? c - '0' : c >= 'a' and c <= 'f' ? 10 + c - 'a' : c >= 'A' and c <= 'F' ? 10 + c - 'A' : 0xFF;
+            }
+            return values;
+        }
+        // The two hex characters of each byte.
+        static constexpr std::array<char, 512> hex_character_pairs(const bool uppercase)
+        {
+            std::array<char, 512> pairs{};
+            const char* characters = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+            for(int byte = 0; byte < 256; byte++)
+            {
+                pairs[2 * byte] = characters[byte >> 4];
+                pairs[2 * byte + 1] = characters[byte & 0xF];
+            }
+            return pairs;
+        }
+        // Read integers from hex strings, a digit (eight characters) at a time through a table of character values.
+        static integer_digits digits_from_hex_string(const std::string_view str)
+        {
+            static constexpr std::array<unsigned char, 256> values = hex_character_values();
+            digit_buffer result((str.size() + 7) / 8);
+            // Invalid characters have the high half of their value set, which is collected here and checked once at the end.
+            unsigned invalid = 0;
+            std::size_t end = str.size();
+            for(digit& d : result)
+            {
+                const std::size_t begin = end >= 8 ? end - 8 : 0;
+                digit value = 0;
+                for(std::size_t i = begin; i < end; i++)
+                {
+                    const unsigned character_value = values[static_cast<unsigned char>(str[i])];
+                    invalid |= character_value;
+                    value = (value << 4) | (character_value & 0xF);
+                }
+                d = value;
+                end = begin;
+            }
+            if((invalid & 0xF0) != 0)
+            {
+                throw std::logic_error("Invalid digit.");
+            }
+            trim(result);
+            return digits_from_buffer(result);
+        }
+        // Number of hex characters in non-zero digits.
+        static std::size_t hex_length(const integer_digits& digits)
+        {
+            return 8 * digits.size() - leading_zeros(digits.back()) / 4;
+        }
+        // Write non-zero digits as their 'length' hex characters (without leading zeroes), a byte at a time through a table of character
+        // pairs.
+        static void write_hex(const integer_digits& digits, char* str, const std::size_t length, const bool uppercase)
+        {
+            static constexpr std::array<char, 512> upper_pairs = hex_character_pairs(true), lower_pairs = hex_character_pairs(false);
+            const char* pairs = uppercase ? upper_pairs.data() : lower_pairs.data();
+            const auto write_digit = [pairs](digit d, char* last)
+            {
+                for(int i = 0; i < 4; i++, d >>= 8)
+                {
+                    last -= 2;
+                    last[0] = pairs[2 * (d & 0xFF)];
+                    last[1] = pairs[2 * (d & 0xFF) + 1];
+                }
+            };
+            // All digits but the top one are written in full, from the end of the string.
+            char* last = str + length;
+            immer::for_each_chunk(digits.take(digits.size() - 1), [&](const digit* first, const digit* chunk_last)
+            {
+                for(; first != chunk_last; ++first, last -= 8)
+                {
+                    write_digit(*first, last);
+                }
+            });
+            char top[8];
+            write_digit(digits.back(), top + 8);
+            std::copy(top + 8 - (last - str), top + 8, str);
+        }
+        // Read integers from strings in a radix of 2^bits. Each character holds 'bits' bits, which are sliced into the digits from the
+        // right.
+        static integer_digits digits_from_power_of_two_string(const std::string_view str, const int bits)
+        {
+            digit_buffer result;
+            result.reserve(str.size() * bits / 32 + 1);
+            superdigit accumulator = 0;
+            int accumulated = 0;
+            for(std::size_t i = str.size(); i-- > 0;)
+            {
+                const int value = get_digit_character_value(str[i]);
+                if(value >> bits != 0)
+                {
+                    throw std::logic_error("Invalid digit.");
+                }
+                accumulator |= static_cast<superdigit>(value) << accumulated;
+                accumulated += bits;
+                if(accumulated >= 32)
+                {
+                    result.push_back(static_cast<digit>(accumulator));
+                    accumulator >>= 32;
+                    accumulated -= 32;
+                }
+            }
+            result.push_back(static_cast<digit>(accumulator));
+            trim(result);
+            return digits_from_buffer(result);
+        }
+        // The byte order of the target for endian::native, and the others as they are.
+        static endian resolve_endian(const endian order)
+        {
+            if(order != endian::native)
+            {
+                return order;
+            }
+#if defined(__BYTE_ORDER__)
+            return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? endian::little : endian::big;
+#else
+            const digit probe = 1;
+            unsigned char first;
+            std::memcpy(&first, &probe, 1);
+            return first == 1 ? endian::little : endian::big;
+#endif
+        }
+        // Where the i-th byte of a value (counting from the least significant) is, among 'count' words of 'word_size' bytes.
+        static std::size_t byte_position(const std::size_t i, const std::size_t count, const std::size_t word_size, const bool is_little_word,
+                                         const bool is_little_byte)
+        {
+            const std::size_t word = i / word_size, byte = i % word_size;
+            return (is_little_word ? word : count - 1 - word) * word_size + (is_little_byte ? byte : word_size - 1 - byte);
+        }
+        // Digits are serialized and loaded in blocks of this many, which stay in the cache between the copy, the checksum and the vector.
+        static constexpr std::size_t serialization_block_size = 1 << 14;
+        // Running checksum of serialized digits: a Fletcher-style pair of sums, so that the order of the digits matters too.
+        static void update_checksum(superdigit& low, superdigit& high, const digit* digits, const std::size_t count)
+        {
+            for(std::size_t i = 0; i < count; i++)
+            {
+                low += digits[i];
+                high += low;
+            }
+        }
+        // The checksum of a sign, a digit count and the sums of the digits.
+        static superdigit finish_checksum(const superdigit low, const superdigit high)
+        {
+            return high ^ (low << 32) ^ (low >> 32);
+        }
+        // The checksum sums start from the sign and the digit count.
+        static void start_checksum(superdigit& low, superdigit& high, const bool is_negative, const std::size_t count)
+        {
+            low = 2 * static_cast<superdigit>(count) + (is_negative ? 1 : 0);
+            high = 0;
+        }
+        // Store a little-endian value of 'bytes' bytes.
+        static void store_little_endian(unsigned char* bytes, superdigit value, const std::size_t size)
+        {
+            for(std::size_t i = 0; i < size; i++, value >>= 8)
+            {
+                bytes[i] = static_cast<unsigned char>(value);
+            }
+        }
+        // Load a little-endian value of 'bytes' bytes.
+        static superdigit load_little_endian(const unsigned char* bytes, const std::size_t size)
+        {
+            superdigit value = 0;
+            for(std::size_t i = size; i-- > 0;)
+            {
+                value = (value << 8) | bytes[i];
+            }
+            return value;
+        }
+        // Store digits as little-endian bytes (returns the end of what was written). On little-endian targets this is a plain copy.
+        static unsigned char* store_digits(const digit* digits, const std::size_t count, unsigned char* bytes)
+        {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            if(count != 0)
+            {
+                std::memcpy(bytes, digits, 4 * count);
+            }
+#else
+            for(std::size_t i = 0; i < count; i++)
+            {
+                store_little_endian(bytes + 4 * i, digits[i], 4);
+            }
+#endif
+            return bytes + 4 * count;
+        }
+        // Load digits from little-endian bytes.
+        static void load_digits(const unsigned char* bytes, const std::size_t count, digit* digits)
+        {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            if(count != 0)
+            {
+                std::memcpy(digits, bytes, 4 * count);
+            }
+#else
+            for(std::size_t i = 0; i < count; i++)
+            {
+                digits[i] = static_cast<digit>(load_little_endian(bytes + 4 * i, 4));
+            }
+#endif
+        }
+        // Write the header for x.
+        static void write_serialization_header(const integer& x, unsigned char* header)
+        {
+            const bool is_negative = x.is_negative and !x.digits.empty();
+            superdigit low, high;
+            start_checksum(low, high, is_negative, x.digits.size());
+            immer::for_each_chunk(x.digits, [&low, &high](const digit* first, const digit* last)
+            {
+                update_checksum(low, high, first, last - first);
+            });
+            std::copy(serialization_magic, serialization_magic + 4, header);
+            store_little_endian(header + 4, serialization_version, 2);
+            header[6] = is_negative ? 1 : 0;
+            header[7] = 0;
+            store_little_endian(header + 8, x.digits.size(), 8);
+            store_little_endian(header + 16, finish_checksum(low, high), 8);
+        }
+        // Check a header (returns the digit count).
+        static std::size_t read_serialization_header(const unsigned char* header, bool& is_negative, superdigit& checksum)
+        {
+            if(!std::equal(serialization_magic, serialization_magic + 4, header) or load_little_endian(header + 4, 2) != serialization_version
+               or header[6] > 1 or header[7] != 0)
+            {
+                throw std::runtime_error("Invalid serialized integer.");
+            }
+            is_negative = header[6] == 1;
+            checksum = load_little_endian(header + 16, 8);
+            return static_cast<std::size_t>(load_little_endian(header + 8, 8));
+        }
+        // Build the digits block by block, each block being filled by 'read' (given the block and its size), and check them against the
+        // checksum.
+        template<typename Read>
+        static integer load_digits(const std::size_t count, const bool is_negative, const superdigit checksum, Read&& read)
+        {
+            superdigit low, high;
+            start_checksum(low, high, is_negative, count);
+            integer_digits digits;
+            digit_buffer block(std::min(count, serialization_block_size));
+            for(std::size_t done = 0; done < count;)
+            {
+                const std::size_t size = std::min(count - done, serialization_block_size);
+                read(block.data(), size);
+                update_checksum(low, high, block.data(), size);
+                digits = std::move(digits) + integer_digits(block.begin(), block.begin() + size);
+                done += size;
+            }
+            if(finish_checksum(low, high) != checksum or (count != 0 and digits.back() == 0))
+            {
+                throw std::runtime_error("Invalid serialized integer.");
+            }
+            return create(digits, is_negative and count != 0);
+        }
+        static constexpr unsigned char serialization_magic[4] = {'I', 'T', 'T', 'N'};
+        // Write non-zero digits as their 'length' characters in a radix of 2^bits, slicing 'bits' bits off the digits for each character,
+        // from the right.
+        static void write_power_of_two(const integer_digits& digits, char* str, const std::size_t length, const int bits, const bool uppercase)
+        {
+            const superdigit mask = (superdigit(1) << bits) - 1;
+            char* last = str + length;
+            superdigit accumulator = 0;
+            int accumulated = 0;
+            immer::for_each_chunk(digits, [&](const digit* first, const digit* chunk_last)
+            {
+                for(; first != chunk_last; ++first)
+                {
+                    accumulator |= static_cast<superdigit>(*first) << accumulated;
+                    accumulated += 32;
+                    for(; accumulated >= bits and last != str; accumulated -= bits, accumulator >>= bits)
+                    {
+                        *--last = get_digit_character(static_cast<int>(accumulator & mask), uppercase);
+                    }
+                }
+            });
+            for(; last != str; accumulator >>= bits)
+            {
+                *--last = get_digit_character(static_cast<int>(accumulator & mask), uppercase);
+            }
+        }
+        // Read integers from strings in other radices. The string is cut into chunks of as many characters as fit a superdigit (19 for
+        // decimal), which are joined by divide and conquer: the upper half of the chunks is multiplied by a cached power of the chunk base
+        // and the lower half is added. With Karatsuba multiplication, this is subquadratic.
+        static integer_digits digits_from_radix_string(const std::string_view str, const int radix)
+        {
+            const std::size_t chunk_size = radix_chunk_size(radix);
+            const std::size_t chunk_count = (str.size() + chunk_size - 1) / chunk_size;
+            std::vector<superdigit> chunks(chunk_count);
+            // The chunks are little-endian, so the most significant (and possibly shorter) one comes last.
+            std::size_t end = str.size();
+            for(std::size_t i = 0; i < chunk_count; i++)
+            {
+                const std::size_t begin = end >= chunk_size ? end - chunk_size : 0;
+                chunks[i] = radix_chunk_value(str.data() + begin, end - begin, radix);
+                end = begin;
+            }
+            digit_buffer result = join_radix_chunks(chunks.data(), chunk_count, radix);
+            trim(result);
+            return digits_from_buffer(result);
+        }
+        // Write non-zero digits in other radices into a buffer of 'size' characters, enough to hold them (returns the end of what was
+        // written). The value is split by divide and conquer: dividing by (chunk base)^(2^level) from the cached powers gives the upper and
+        // the lower half of its chunks, and small values are split by division by the chunk base. The characters are written backwards
+        // from the end of the buffer, all but the top chunk with leading zeroes, and then moved to its start.
+        static char* write_radix(const integer_digits& digits, char* str, const std::size_t size, const int radix, const bool uppercase)
+        {
+            const digit_buffer magnitude = buffer_from_digits(digits);
+            // A chunk holds at least floor(log2(chunk base)) bits.
+            const std::size_t chunk_bits = 63 - leading_zeros(radix_chunk_base(radix));
+            const std::size_t bits = 32 * magnitude.size() - leading_zeros(magnitude.back());
+            std::size_t level = 0;
+            while((chunk_bits << level) < bits)
+            {
+                level++;
+            }
+            const char* const first = write_radix_top(magnitude, str + size, level, radix, uppercase);
+            return std::copy(first, static_cast<const char*>(str + size), str);
+        }
+        // Multiplication of base 2^32 digits.
+        static superdigit multiply_digits(const digit x, const digit y)
+        {
+            const superdigit p = static_cast<superdigit>(x) * static_cast<superdigit>(y);
+            return p;
+        }
+        // A vector of 'count' zero digits. It is built by doubling a shared block of zeroes, so all of its leaves are shared and it costs
+        // O(log^2 count) instead of O(count).
+        static integer_digits zero_digits(const std::size_t count)
+        {
+            static const integer_digits block(zero_block_size, 0);
+            integer_digits result = block.take(count % zero_block_size);
+            integer_digits power = block;
+            for(std::size_t blocks = count / zero_block_size; blocks != 0; blocks /= 2)
+            {
+                if(blocks % 2 != 0)
+                {
+                    result = power + result;
+                }
+                if(blocks > 1)
+                {
+                    power = power + power;
+                }
+            }
+            return result;
+        }
+        // Size of the block of zeroes that zero_digits is built from.
+        static constexpr std::size_t zero_block_size = 1024;
+        // result[i] = (x[i] << bits) | (x[i - 1] >> (32 - bits)) for bits in (0, 32), with 'previous' standing for x[-1]. Every digit is
+        // computed independently of the others, so the loop vectorizes.
+        static void funnel_shift_left(digit* result, const digit* x, const std::size_t size, const int bits, const digit previous)
+        {
+            if(size == 0)
+            {
+                return;
+            }
+            result[0] = (x[0] << bits) | (previous >> (32 - bits));
+            for(std::size_t i = 1; i < size; i++)
+            {
+                result[i] = (x[i] << bits) | (x[i - 1] >> (32 - bits));
+            }
+        }
+        // result[i] = (x[i] >> bits) | (x[i + 1] << (32 - bits)) for bits in (0, 32), with 'next' standing for x[size].
+        static void funnel_shift_right(digit* result, const digit* x, const std::size_t size, const int bits, const digit next)
+        {
+            if(size == 0)
+            {
+                return;
+            }
+            for(std::size_t i = 0; i + 1 < size; i++)
+            {
+                result[i] = (x[i] >> bits) | (x[i + 1] << (32 - bits));
+            }
+            result[size - 1] = (x[size - 1] >> bits) | (next << (32 - bits));
+        }
+        // Flip a bit of |x|, keeping the sign of x.
+        static integer flip_magnitude_bit(integer x, const std::size_t index)
+        {
+            const std::size_t position = index / 32;
+            const digit bit = digit(1) << (index % 32);
+            if(position >= x.digits.size())
+            {
+                x.digits = std::move(x.digits) + zero_digits(position - x.digits.size());
+                x.digits = std::move(x.digits).push_back(bit);
+                return x;
+            }
+            const digit d = x.digits[position] ^ bit;
+            x.digits = std::move(x.digits).set(position, d);
+            while(!x.digits.empty() and x.digits.back() == 0)
+            {
+                x.digits = std::move(x.digits).take(x.digits.size() - 1);
+            }
+            return x;
+        }
+        // Index of the lowest set bit at or above 'start' in the digits xored with 'mask', where the digits past the end are taken as 'mask'
+        // (returns npos if there is none).
+        static std::size_t find_bit(const integer_digits& digits, const std::size_t start, const digit mask)
+        {
+            const std::size_t position = start / 32;
+            if(position >= digits.size())
+            {
+                return mask != 0 ? start : npos;
+            }
+            std::size_t index = 32 * position;
+            digit first_mask = max_digit << (start % 32);
+            const bool is_found = !immer::for_each_chunk_p(digits.drop(position), [&](const digit* first, const digit* last)
+            {
+                for(; first != last; ++first)
+                {
+                    const digit d = (*first ^ mask) & first_mask;
+                    if(d != 0)
+                    {
+                        index += trailing_zeros(d);
+                        return false;
+                    }
+                    first_mask = max_digit;
+                    index += 32;
+                }
+                return true;
+            });
+            return is_found or mask != 0 ? index : npos;
+        }
+        // Apply a bitwise operation to the infinite two's complement forms of x and y. A negative value -m is ~(m - 1), so the negative
+        // magnitudes are decremented and then complemented on the fly by xoring with a mask, and a negative result is converted back the
+        // same way. The operation applied to the masks tells the sign of the result.
+        template<typename Operation>
+        static integer bitwise(const integer& x, const integer& y, Operation operation)
+        {
+            const digit x_mask = x.is_negative and !x.digits.empty() ? max_digit : 0;
+            const digit y_mask = y.is_negative and !y.digits.empty() ? max_digit : 0;
+            const digit result_mask = operation(x_mask, y_mask);
+            digit_buffer x_buffer = buffer_from_digits(x.digits), y_buffer = buffer_from_digits(y.digits);
+            const std::size_t size = std::max(x_buffer.size(), y_buffer.size());
+            const digit unit = 1;
+            if(x_mask != 0)
+            {
+                subtract_digits(x_buffer.data(), x_buffer.size(), &unit, 1);
+            }
+            if(y_mask != 0)
+            {
+                subtract_digits(y_buffer.data(), y_buffer.size(), &unit, 1);
+            }
+            x_buffer.resize(size);
+            y_buffer.resize(size);
+            // One more digit for the carry of a negative result (whose magnitude is at most 2^(32 * size)).
+            digit_buffer result(size + 1);
+            bitwise_digits(result.data(), x_buffer.data(), y_buffer.data(), size, x_mask, y_mask, result_mask, operation);
+            if(result_mask != 0)
+            {
+                add_digits(result.data(), result.size(), &unit, 1);
+            }
+            trim(result);
+            return create(digits_from_buffer(result), result_mask != 0);
+        }
+        // result[i] = operation(x[i] ^ x_mask, y[i] ^ y_mask) ^ result_mask. There is no carry between the digits, so the loop vectorizes.
+        template<typename Operation>
+        static void bitwise_digits(digit* result, const digit* x, const digit* y, const std::size_t size, const digit x_mask, const digit y_mask,
+                                   const digit result_mask, Operation operation)
+        {
+            for(std::size_t i = 0; i < size; i++)
+            {
+                result[i] = operation(x[i] ^ x_mask, y[i] ^ y_mask) ^ result_mask;
+            }
+        }
+        // |x| + w, keeping the sign of x. Only the digits the carry reaches are updated, the rest stay shared.
+        static integer add_magnitude_word(integer x, const superdigit w)
+        {
+            superdigit carry = w;
+            for(std::size_t i = 0; carry != 0; i++)
+            {
+                if(i == x.digits.size())
+                {
+                    x.digits = x.digits.push_back(static_cast<digit>(carry));
+                    carry >>= 32;
+                    continue;
+                }
+                const superdigit sum = static_cast<superdigit>(x.digits[i]) + static_cast<digit>(carry);
+                x.digits = x.digits.set(i, static_cast<digit>(sum));
+                carry = (carry >> 32) + (sum >> 32);
+            }
+            return x;
+        }
+        // |x| - w, keeping the sign of x, where |x| is at least w. Only the digits the borrow reaches are updated.
+        static integer subtract_magnitude_word(integer x, const superdigit w)
+        {
+            superdigit borrow = w;
+            for(std::size_t i = 0; borrow != 0; i++)
+            {
+                const digit d = x.digits[i], taken = static_cast<digit>(borrow);
+                x.digits = x.digits.set(i, d - taken);
+                borrow = (borrow >> 32) + (d < taken ? 1 : 0);
+            }
+            while(!x.digits.empty() and x.digits.back() == 0)
+            {
+                x.digits = std::move(x.digits).take(x.digits.size() - 1);
+            }
+            return x;
+        }
+        // Contiguous little-endian digit buffer, used by the kernels that need random access to the digits.
+        using digit_buffer = std::vector<digit>;
+        // 10^exponent, by repeated squaring.
+        static digit_buffer power_of_ten(std::size_t exponent)
+        {
+            digit_buffer result{1}, power{10};
+            for(; exponent != 0; exponent /= 2)
+            {
+                if(exponent % 2 != 0)
+                {
+                    result = multiply_buffers(result, power);
+                }
+                if(exponent > 1)
+                {
+                    power = multiply_buffers(power, power);
+                }
+            }
+            return result;
+        }
+        // Up to this many chunks of a radix are converted one by one (by multiplying or dividing by the chunk base), and above it, by divide
+        // and conquer.
+        static constexpr std::size_t radix_chunk_threshold = 32;
+        // Powers of a chunk base are cached until one has this many digits, so they take at most a megabyte per radix.
+        static constexpr std::size_t radix_power_cache_limit = std::size_t(1) << 16;
+        // Number of characters in a chunk of a radix: the most whose values all fit a superdigit (19 for decimal).
+        static std::size_t radix_chunk_size(const int radix)
+        {
+            std::size_t size = 1;
+            for(superdigit base = radix; base <= std::numeric_limits<superdigit>::max() / radix; base *= radix)
+            {
+                size++;
+            }
+            return size;
+        }
+        // The chunk base of a radix, i.e. radix^(chunk size).
+        static superdigit radix_chunk_base(const int radix)
+        {
+            superdigit base = radix;
+            while(base <= std::numeric_limits<superdigit>::max() / radix)
+            {
+                base *= radix;
+            }
+            return base;
+        }
+        // (chunk base)^(2^level) for a radix. The powers up to the first of radix_power_cache_limit digits are cached for reuse by all
+        // conversions (the cache is shared between threads). Larger ones are squared from the largest cached one on each call, so the
+        // cache stays bounded however large the numbers converted are. Such a power is only needed by the top few levels of a
+        // conversion, where squaring it costs about as much as the one multiplication or division it is used for.
+        static digit_buffer radix_power(const int radix, const std::size_t level)
+        {
+            static std::mutex mutex;
+            static std::vector<digit_buffer> powers[37];
+            digit_buffer result;
+            std::size_t result_level;
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                std::vector<digit_buffer>& radix_powers = powers[radix];
+                if(radix_powers.empty())
+                {
+                    const superdigit base = radix_chunk_base(radix);
+                    radix_powers.push_back({static_cast<digit>(base), static_cast<digit>(base >> 32)});
+                }
+                while(radix_powers.size() <= level and radix_powers.back().size() < radix_power_cache_limit)
+                {
+                    radix_powers.push_back(square_buffers(radix_powers.back()));
+                }
+                result_level = std::min(level, radix_powers.size() - 1);
+                result = radix_powers[result_level];
+            }
+            for(; result_level < level; result_level++)
+            {
+                result = square_buffers(result);
+            }
+            return result;
+        }
+        // Value of a string of at most a chunk of characters. In decimal, whole groups of eight digits are converted at once, as bytes
+        // within a superdigit (SWAR), and the rest one by one.
+        static superdigit radix_chunk_value(const char* str, std::size_t length, const int radix)
+        {
+            superdigit value = 0;
+            if(radix == 10)
+            {
+                for(; length >= 8; str += 8, length -= 8)
+                {
+                    value = value * 100'000'000 + eight_decimal_digits_value(str);
+                }
+            }
+            for(; length != 0; str++, length--)
+            {
+                const int character_value = get_digit_character_value(*str);
+                if(character_value >= radix)
+                {
+                    throw std::logic_error("Invalid digit.");
+                }
+                value = value * radix + character_value;
+            }
+            return value;
+        }
+        // Value of eight decimal digits, computed on all of them at once: each step merges neighbouring pairs of values (digits, then
+        // two-digit values, then four-digit ones) within the superdigit.
+        static superdigit eight_decimal_digits_value(const char* str)
+        {
+            superdigit value = 0;
+            for(int i = 0; i < 8; i++)
+            {
+                value |= static_cast<superdigit>(static_cast<unsigned char>(str[i])) << (8 * i);
+            }
+            // Every byte must be in '0'-'9', i.e. have 3 as its high half, and still have it after adding 6.
+            const superdigit high_halves = 0xF0F0F0F0F0F0F0F0ull, zeroes = 0x3030303030303030ull;
+            if((value & high_halves) != zeroes or ((value + 0x0606060606060606ull) & high_halves) != zeroes)
+            {
+                throw std::logic_error("Invalid digit.");
+            }
+            value -= zeroes;
+            value = (value * 10 + (value >> 8)) & 0x00FF00FF00FF00FFull;
+            value = (value * 100 + (value >> 16)) & 0x0000FFFF0000FFFFull;
+            value = (value * 10000 + (value >> 32)) & 0x00000000FFFFFFFFull;
+            return value;
+        }
+        // The value of little-endian chunks of a radix.
+        static digit_buffer join_radix_chunks(const superdigit* chunks, const std::size_t count, const int radix)
+        {
+            if(count <= radix_chunk_threshold)
+            {
+                const superdigit base = radix_chunk_base(radix);
+                digit_buffer result(2 * count + 1);
+                std::size_t size = 0;
+                for(std::size_t i = count; i-- > 0;)
+                {
+                    const superdigit carry = multiply_add_word(result.data(), size, base, chunks[i]);
+                    result[size] = static_cast<digit>(carry);
+                    result[size + 1] = static_cast<digit>(carry >> 32);
+                    size += 2;
+                    while(size != 0 and result[size - 1] == 0)
+                    {
+                        size--;
+                    }
+                }
+                result.resize(size);
+                return result;
+            }
+            // The lower half holds 2^level chunks, so the upper one is multiplied by (chunk base)^(2^level).
+            std::size_t level = 0;
+            while((std::size_t(2) << level) < count)
+            {
+                level++;
+            }
+            const std::size_t half = std::size_t(1) << level;
+            return join_radix_halves(join_radix_chunks(chunks + half, count - half, radix), join_radix_chunks(chunks, half, radix),
+                                     radix_power(radix, level));
+        }
+        // high * power + low, where low is below the power.
+        static digit_buffer join_radix_halves(const digit_buffer& high, const digit_buffer& low, const digit_buffer& power)
+        {
+            if(high.empty())
+            {
+                return low;
+            }
+            digit_buffer result(high.size() + power.size());
+            multiply_buffers(result.data(), high.data(), high.size(), power.data(), power.size());
+            add_digits(result.data(), result.size(), low.data(), low.size());
+            trim(result);
+            return result;
+        }
+        // Below this many digits (of the shorter operand), buffers are multiplied with the schoolbook method.
+        static constexpr std::size_t karatsuba_threshold = 32;
+        // Divisors and quotients of at least this many digits are divided with Burnikel-Ziegler recursive division (which recurses down to
+        // blocks below it). Against Knuth's algorithm on 2n / n digits, it breaks even around 96 digits and is 1.7x faster at 512.
+        static constexpr std::size_t burnikel_ziegler_threshold = 96;
+        // Exact quotients of at least this many digits are computed from both ends at once.
+        static constexpr std::size_t bidirectional_exact_division_threshold = 48;
+        // Divisors of at least this many digits get a Newton reciprocal when it is precomputed for reuse, which is where dividing with it
+        // starts to beat Burnikel-Ziegler division (and below it, the reciprocal is computed by division). A one-off division never
+        // computes one: with Karatsuba multiplication, that costs more than Burnikel-Ziegler division at every measured size.
+        static constexpr std::size_t reciprocal_threshold = 2048;
+        // The half-gcd algorithm recurses while at least this many digits are to be reduced (and below it, goes on with Lehmer's).
+        static constexpr std::size_t half_gcd_threshold = 64;
+        // Operands of at least this many digits are reduced by the half-gcd algorithm in gcd computations, and smaller ones (where its
+        // matrix products do not pay off yet) by Lehmer's.
+        static constexpr std::size_t subquadratic_gcd_threshold = 2048;
+        // Copy the digits into a contiguous buffer (without leading zeroes).
+        static digit_buffer buffer_from_digits(const integer_digits& digits)
+        {
+            digit_buffer buffer;
+            buffer.reserve(digits.size());
+            immer::for_each_chunk(digits, [&buffer](const digit* first, const digit* last)
+            {
+                buffer.insert(buffer.end(), first, last);
+            });
+            trim(buffer);
+            return buffer;
+        }
+        // Build the digits from a buffer without leading zeroes.
+        static integer_digits digits_from_buffer(const digit_buffer& buffer)
+        {
+            assert(buffer.empty() or buffer.back() != 0);
+            return integer_digits(buffer.begin(), buffer.end());
+        }
+        // Remove leading zeroes from a buffer.
+        static void trim(digit_buffer& buffer)
+        {
+            while(!buffer.empty() and buffer.back() == 0)
+            {
+                buffer.pop_back();
+            }
+        }
+        // Compare the values in two buffers without leading zeroes (returns -1, 0 or 1).
+        static int compare_buffers(const digit* x, const std::size_t x_size, const digit* y, const std::size_t y_size)
+        {
+            if(x_size != y_size)
+            {
+                return x_size < y_size ? -1 : 1;
+            }
+            for(std::size_t i = x_size; i-- > 0;)
+            {
+                if(x[i] != y[i])
+                {
+                    return x[i] < y[i] ? -1 : 1;
+                }
+            }
+            return 0;
+        }
+        // Number of leading zero bits in a non-zero digit.
+        static int leading_zeros(const digit d)
+        {
+            assert(d != 0);
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_clz(d);
+#else
+            int count = 0;
+            for(digit bit = digit(1) << 31; !(d & bit); bit >>= 1)
+            {
+                count++;
+            }
+            return count;
+#endif
+        }
+        // Number of trailing zero bits in a non-zero digit.
+        static int trailing_zeros(const digit d)
+        {
+            assert(d != 0);
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctz(d);
+#else
+            int count = 0;
+            for(digit bit = 1; !(d & bit); bit <<= 1)
+            {
+                count++;
+            }
+            return count;
+#endif
+        }
+        // Number of set bits in a digit. Summed over a buffer, this vectorizes to VPOPCNT where AVX-512 allows it.
+        static int population_count(const digit d)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_popcount(d);
+#else
+            int count = 0;
+            for(digit rest = d; rest != 0; rest &= rest - 1)
+            {
+                count++;
+            }
+            return count;
+#endif
+        }
+        // Number of leading zero bits in a non-zero word.
+        static int leading_zeros(const superdigit w)
+        {
+            assert(w != 0);
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_clzll(w);
+#else
+            const digit high = static_cast<digit>(w >> 32);
+            return high != 0 ? leading_zeros(high) : 32 + leading_zeros(static_cast<digit>(w));
+#endif
+        }
+        // Number of trailing zero bits of a non-zero word.
+        static int trailing_zeros(const superdigit w)
+        {
+            assert(w != 0);
+            const digit low = static_cast<digit>(w);
+            return low != 0 ? trailing_zeros(low) : 32 + trailing_zeros(static_cast<digit>(w >> 32));
+        }
+        // Full product of two words (returns the low word, the high one goes to 'high').
+        static superdigit multiply_words(const superdigit x, const superdigit y, superdigit& high)
+        {
+#if defined(__SIZEOF_INT128__)
+            const unsigned __int128 product = static_cast<unsigned __int128>(x) * y;
+            high = static_cast<superdigit>(product >> 64);
+            return static_cast<superdigit>(product);
+#else
+            const superdigit x0 = static_cast<digit>(x), x1 = x >> 32, y0 = static_cast<digit>(y), y1 = y >> 32;
+            const superdigit low = x0 * y0, middle1 = x1 * y0, middle2 = x0 * y1;
+            const superdigit middle = (low >> 32) + static_cast<digit>(middle1) + static_cast<digit>(middle2);
+            high = x1 * y1 + (middle1 >> 32) + (middle2 >> 32) + (middle >> 32);
+            return (middle << 32) | static_cast<digit>(low);
+#endif
+        }
+        // Möller-Granlund reciprocal of a normalized (top bit set) word d: floor((2^128 - 1) / d) - 2^64.
+        static superdigit word_reciprocal(const superdigit d)
+        {
+            assert(d >> 63 == 1);
+#if defined(__SIZEOF_INT128__)
+            return static_cast<superdigit>(((static_cast<unsigned __int128>(~d) << 64) | ~superdigit(0)) / d);
+#else
+            // Schoolbook division of (~d, ~0) by d in half words (the quotient fits a word, since ~d < d).
+            const superdigit half = superdigit(1) << 32, mask = half - 1;
+            const superdigit d1 = d >> 32, d0 = d & mask, high = ~d, low = ~superdigit(0);
+            superdigit q1 = high / d1, r = high - q1 * d1;
+            while(q1 >= half or q1 * d0 > ((r << 32) | (low >> 32)))
+            {
+                q1--;
+                r += d1;
+                if(r >= half)
+                {
+                    break;
+                }
+            }
+            const superdigit middle = (high << 32) + (low >> 32) - q1 * d;
+            superdigit q0 = middle / d1;
+            r = middle - q0 * d1;
+            while(q0 >= half or q0 * d0 > ((r << 32) | (low & mask)))
+            {
+                q0--;
+                r += d1;
+                if(r >= half)
+                {
+                    break;
+                }
+            }
+            return (q1 << 32) | q0;
+#endif
+        }
+        // Divide the two-word value (high, low) by a normalized word d with its Möller-Granlund reciprocal, where high < d.
+        static superdigit divide_words(const superdigit high, const superdigit low, const superdigit d, const superdigit inverse, superdigit& remainder)
+        {
+            superdigit quotient_high;
+            superdigit quotient_low = multiply_words(inverse, high, quotient_high);
+            quotient_low += low;
+            quotient_high += high + (quotient_low < low ? 1 : 0) + 1;
+            superdigit r = low - quotient_high * d;
+            if(r > quotient_low)
+            {
+                quotient_high--;
+                r += d;
+            }
+            if(r >= d)
+            {
+                quotient_high++;
+                r -= d;
+            }
+            remainder = r;
+            return quotient_high;
+        }
+        // Divide digits by a non-zero word in a single pass from the top, over pairs of digits, using division by an invariant word.
+        // Each quotient word is passed (from the top) to 'emit'; returns the remainder.
+        template<typename Emit>
+        static superdigit divide_by_word(const integer_digits& digits, const superdigit y, Emit&& emit)
+        {
+            // Normalize the divisor, and shift the dividend along with it on the fly.
+            const int shift = leading_zeros(y);
+            const superdigit d = y << shift, inverse = word_reciprocal(d);
+            superdigit remainder = 0, previous = 0;
+            const auto divide_next = [&](const superdigit word)
+            {
+                const superdigit shifted = (previous << shift) | (shift != 0 ? word >> (64 - shift) : 0);
+                emit(divide_words(remainder, shifted, d, inverse, remainder));
+                previous = word;
+            };
+            auto it = digits.rbegin();
+            if(digits.size() % 2 != 0)
+            {
+                divide_next(*it++);
+            }
+            while(it != digits.rend())
+            {
+                const superdigit high = *it++;
+                divide_next((high << 32) | *it++);
+            }
+            divide_next(0);
+            return remainder >> shift;
+        }
+        // x * y + a + b (returns the low word, the high one goes to 'high'), which cannot overflow two words.
+        static superdigit multiply_add_words(const superdigit x, const superdigit y, const superdigit a, const superdigit b, superdigit& high)
+        {
+#if defined(__SIZEOF_INT128__)
+            const unsigned __int128 result = static_cast<unsigned __int128>(x) * y + a + b;
+            high = static_cast<superdigit>(result >> 64);
+            return static_cast<superdigit>(result);
+#else
+            superdigit low = multiply_words(x, y, high);
+            low += a;
+            high += low < a ? 1 : 0;
+            low += b;
+            high += low < b ? 1 : 0;
+            return low;
+#endif
+        }
+        // result = (top, t) - m if that is not negative, else (top, t), for n-word t and m.
+        template<typename Size>
+        static void subtract_modulus_if_needed(superdigit* result, const superdigit* t, const superdigit top, const superdigit* m, const Size n)
+        {
+            bool is_at_least_modulus = top != 0;
+            if(!is_at_least_modulus)
+            {
+                is_at_least_modulus = true;
+                for(std::size_t i = n; i-- > 0;)
+                {
+                    if(t[i] != m[i])
+                    {
+                        is_at_least_modulus = t[i] > m[i];
+                        break;
+                    }
+                }
+            }
+            if(!is_at_least_modulus)
+            {
+                std::copy(t, t + n, result);
+                return;
+            }
+            superdigit borrow = 0;
+            for(std::size_t i = 0; i < n; i++)
+            {
+                const superdigit difference = t[i] - m[i] - borrow;
+                borrow = (t[i] < m[i] or (t[i] == m[i] and borrow != 0)) ? 1 : 0;
+                result[i] = difference;
+            }
+        }
+        // Montgomery multiplication x * y * R^-1 mod m (CIOS: the product and the reduction are interleaved word by word), for n-word
+        // operands in [0, m), with -m^-1 mod 2^64 as 'inverse' and n + 2 words of scratch. The size is either a runtime value or a
+        // std::integral_constant, for which the loops get fully unrolled.
+        template<typename Size>
+        static void montgomery_multiply(superdigit* result, const superdigit* x, const superdigit* y, const superdigit* m, const Size n, const superdigit inverse, superdigit* t)
+        {
+            std::fill(t, t + n + 2, 0);
+            for(std::size_t i = 0; i < n; i++)
+            {
+                // t += x * y[i].
+                superdigit carry = 0;
+                for(std::size_t j = 0; j < n; j++)
+                {
+                    t[j] = multiply_add_words(x[j], y[i], t[j], carry, carry);
+                }
+                superdigit sum = t[n] + carry;
+                t[n + 1] = sum < carry ? 1 : 0;
+                t[n] = sum;
+                // t = (t + q * m) / 2^64, with q picked so that the low word cancels out.
+                const superdigit q = t[0] * inverse;
+                multiply_add_words(q, m[0], t[0], 0, carry);
+                for(std::size_t j = 1; j < n; j++)
+                {
+                    t[j - 1] = multiply_add_words(q, m[j], t[j], carry, carry);
+                }
+                sum = t[n] + carry;
+                t[n - 1] = sum;
+                t[n] = t[n + 1] + (sum < carry ? 1 : 0);
+            }
+            subtract_modulus_if_needed(result, t, t[n], m, n);
+        }
+        // Montgomery reduction t * R^-1 mod m (REDC) of a 2n-word t < m * R, which is overwritten.
+        template<typename Size>
+        static void montgomery_reduce(superdigit* result, superdigit* t, const superdigit* m, const Size n, const superdigit inverse)
+        {
+            superdigit overflow = 0;
+            for(std::size_t i = 0; i < n; i++)
+            {
+                // Add q * m * 2^(64i), with q picked so that word i cancels out.
+                const superdigit q = t[i] * inverse;
+                superdigit carry = 0;
+                for(std::size_t j = 0; j < n; j++)
+                {
+                    t[i + j] = multiply_add_words(q, m[j], t[i + j], carry, carry);
+                }
+                superdigit sum = t[i + n] + carry;
+                superdigit next_overflow = sum < carry ? 1 : 0;
+                sum += overflow;
+                next_overflow += sum < overflow ? 1 : 0;
+                t[i + n] = sum;
+                overflow = next_overflow;
+            }
+            subtract_modulus_if_needed(result, t + n, overflow, m, n);
+        }
+        // Montgomery square x^2 * R^-1 mod m, for an n-word x in [0, m) and 2n words of scratch. The cross products x[i] * x[j] are
+        // computed once and doubled, which saves almost half of the multiplications of montgomery_multiply.
+        template<typename Size>
+        static void montgomery_square(superdigit* result, const superdigit* x, const superdigit* m, const Size n, const superdigit inverse, superdigit* t)
+        {
+            std::fill(t, t + 2 * n, 0);
+            for(std::size_t i = 0; i < n; i++)
+            {
+                superdigit carry = 0;
+                for(std::size_t j = i + 1; j < n; j++)
+                {
+                    t[i + j] = multiply_add_words(x[i], x[j], t[i + j], carry, carry);
+                }
+                t[i + n] = carry;
+            }
+            // Double the cross products, then add the squares on the diagonal.
+            superdigit top = 0;
+            for(std::size_t i = 0; i < 2 * n; i++)
+            {
+                const superdigit w = t[i];
+                t[i] = (w << 1) | top;
+                top = w >> 63;
+            }
+            superdigit carry = 0;
+            for(std::size_t i = 0; i < n; i++)
+            {
+                superdigit high;
+                const superdigit low = multiply_words(x[i], x[i], high);
+                t[2 * i] = multiply_add_words(1, t[2 * i], low, carry, carry);
+                t[2 * i + 1] = multiply_add_words(1, t[2 * i + 1], high, carry, carry);
+            }
+            montgomery_reduce(result, t, m, n, inverse);
+        }
+        // x += y, where x has at least as many digits as y (returns the carry out of x).
+        static digit add_digits(digit* x, const std::size_t x_size, const digit* y, const std::size_t y_size)
+        {
+            superdigit carry = 0;
+            std::size_t i = 0;
+            for(; i < y_size; i++)
+            {
+                carry += static_cast<superdigit>(x[i]) + y[i];
+                x[i] = static_cast<digit>(carry);
+                carry >>= 32;
+            }
+            for(; carry != 0 and i < x_size; i++)
+            {
+                carry += x[i];
+                x[i] = static_cast<digit>(carry);
+                carry >>= 32;
+            }
+            return static_cast<digit>(carry);
+        }
+        // x -= y, where x has at least as many digits as y (returns the borrow out of x).
+        static digit subtract_digits(digit* x, const std::size_t x_size, const digit* y, const std::size_t y_size)
+        {
+            digit borrow = 0;
+            std::size_t i = 0;
+            for(; i < y_size; i++)
+            {
+                const superdigit difference = static_cast<superdigit>(x[i]) - y[i] - borrow;
+                x[i] = static_cast<digit>(difference);
+                borrow = static_cast<digit>(difference >> 32) & 1;
+            }
+            for(; borrow != 0 and i < x_size; i++)
+            {
+                borrow = x[i] == 0 ? 1 : 0;
+                x[i]--;
+            }
+            return borrow;
+        }
+        // Write a value below (chunk base)^(2^level) without leading zeroes, backwards from 'last' (returns the first character written).
+        static char* write_radix_top(const digit_buffer& x, char* last, const std::size_t level, const int radix, const bool uppercase)
+        {
+            const std::size_t count = std::size_t(1) << level;
+            const std::size_t chunk_size = radix_chunk_size(radix);
+            if(count <= radix_chunk_threshold)
+            {
+                const superdigit base = radix_chunk_base(radix);
+                const int shift = leading_zeros(base);
+                const superdigit inverse = word_reciprocal(base << shift);
+                digit_buffer rest(x);
+                while(!rest.empty())
+                {
+                    const superdigit value = divide_by_chunk_base(rest.data(), rest.size(), base, shift, inverse);
+                    trim(rest);
+                    if(rest.empty())
+                    {
+                        return write_word(value, last, radix, uppercase);
+                    }
+                    last -= chunk_size;
+                    write_radix_chunk(value, last, chunk_size, radix, uppercase);
+                }
+                return last;
+            }
+            digit_buffer quotient, remainder;
+            divide_buffers(quotient, remainder, x, radix_power(radix, level - 1));
+            if(quotient.empty())
+            {
+                return write_radix_top(remainder, last, level - 1, radix, uppercase);
+            }
+            last -= chunk_size << (level - 1);
+            std::fill(last, last + (chunk_size << (level - 1)), '0');
+            write_radix_chunks(remainder, last, level - 1, radix, uppercase);
+            return write_radix_top(quotient, last, level - 1, radix, uppercase);
+        }
+        // Write a value below (chunk base)^(2^level) as exactly (chunk size) * 2^level characters of a radix, over characters that are
+        // already zeroes.
+        static void write_radix_chunks(const digit_buffer& x, char* str, const std::size_t level, const int radix, const bool uppercase)
+        {
+            const std::size_t count = std::size_t(1) << level;
+            const std::size_t chunk_size = radix_chunk_size(radix);
+            if(x.empty())
+            {
+                return; // The characters are already zeroes.
+            }
+            if(count <= radix_chunk_threshold)
+            {
+                // The chunks come out from the least significant one, which goes last.
+                const superdigit base = radix_chunk_base(radix);
+                const int shift = leading_zeros(base);
+                const superdigit inverse = word_reciprocal(base << shift);
+                digit_buffer rest(x);
+                for(std::size_t i = count; i-- > 0 and !rest.empty();)
+                {
+                    const superdigit value = divide_by_chunk_base(rest.data(), rest.size(), base, shift, inverse);
+                    write_radix_chunk(value, str + chunk_size * i, chunk_size, radix, uppercase);
+                    trim(rest);
+                }
+                return;
+            }
+            digit_buffer quotient, remainder;
+            divide_buffers(quotient, remainder, x, radix_power(radix, level - 1));
+            write_radix_chunks(quotient, str, level - 1, radix, uppercase);
+            write_radix_chunks(remainder, str + (chunk_size << (level - 1)), level - 1, radix, uppercase);
+        }
+        // x /= base in place (returns the remainder). The division uses the Möller-Granlund reciprocal of base << shift (the base normalized),
+        // with each pair of the remainder and the next word shifted along with it.
+        static superdigit divide_by_chunk_base(digit* x, const std::size_t size, const superdigit base, const int shift, const superdigit inverse)
+        {
+            const superdigit d = base << shift;
+            superdigit remainder = 0;
+            std::size_t i = size;
+            if(i % 2 != 0)
+            {
+                // The top digit alone is below the chunk base.
+                i--;
+                remainder = x[i];
+                x[i] = 0;
+            }
+            while(i != 0)
+            {
+                i -= 2;
+                const superdigit word = (static_cast<superdigit>(x[i + 1]) << 32) | x[i];
+                const superdigit high = (remainder << shift) | (shift != 0 ? word >> (64 - shift) : 0);
+                const superdigit quotient = divide_words(high, word << shift, d, inverse, remainder);
+                remainder >>= shift;
+                x[i] = static_cast<digit>(quotient);
+                x[i + 1] = static_cast<digit>(quotient >> 32);
+            }
+            return remainder;
+        }
+        // Write a value below the chunk base of a radix as exactly 'size' characters.
+        static void write_radix_chunk(superdigit value, char* str, const std::size_t size, const int radix, const bool uppercase)
+        {
+            if(radix == 10)
+            {
+                write_decimal_chunk(value, str);
+                return;
+            }
+            for(std::size_t i = size; i-- > 0;)
+            {
+                str[i] = get_digit_character(static_cast<int>(value % radix), uppercase);
+                value /= radix;
+            }
+        }
+        // Write a value below 10^19 as exactly 19 decimal characters, two at a time.
+        static void write_decimal_chunk(superdigit value, char* str)
+        {
+            for(std::size_t i = 19; i > 1; i -= 2)
+            {
+                const auto pair = static_cast<unsigned>(value % 100);
+                value /= 100;
+                str[i - 1] = static_cast<char>('0' + pair % 10);
+                str[i - 2] = static_cast<char>('0' + pair / 10);
+            }
+            str[0] = static_cast<char>('0' + value);
+        }
+        // x = x * m + a, over the size of x (returns the carry).
+        static superdigit multiply_add_word(digit* x, const std::size_t size, const superdigit m, superdigit a)
+        {
+            for(std::size_t i = 0; i < size; i++)
+            {
+                superdigit high;
+                superdigit low = multiply_words(x[i], m, high);
+                low += a;
+                high += low < a ? 1 : 0;
+                x[i] = static_cast<digit>(low);
+                a = (low >> 32) | (high << 32);
+            }
+            return a;
+        }
+        // result += x * d, over the size of x (returns the carry).
+        static digit multiply_add_digit(digit* result, const digit* x, const std::size_t size, const digit d)
+        {
+            superdigit carry = 0;
+            for(std::size_t i = 0; i < size; i++)
+            {
+                carry += multiply_digits(x[i], d) + result[i];
+                result[i] = static_cast<digit>(carry);
+                carry >>= 32;
+            }
+            return static_cast<digit>(carry);
+        }
+        // result -= x * d, over the size of x (returns the borrow, which can be as large as the base).
+        static superdigit multiply_subtract_digit(digit* result, const digit* x, const std::size_t size, const digit d)
+        {
+            superdigit borrow = 0;
+            for(std::size_t i = 0; i < size; i++)
+            {
+                const superdigit product = multiply_digits(x[i], d) + borrow;
+                const digit low = static_cast<digit>(product);
+                borrow = (product >> 32) + (result[i] < low ? 1 : 0);
+                result[i] -= low;
+            }
+            return borrow;
+        }
+        // result = x << bits, for bits in [0, 32) (returns the digit shifted out). Can be done in place.
+        static digit shift_digits_left(digit* result, const digit* x, const std::size_t size, const int bits)
+        {
+            digit carry = 0;
+            for(std::size_t i = 0; i < size; i++)
+            {
+                const superdigit shifted = static_cast<superdigit>(x[i]) << bits;
+                result[i] = static_cast<digit>(shifted) | carry;
+                carry = static_cast<digit>(shifted >> 32);
+            }
+            return carry;
+        }
+        // result = x >> bits, for bits in [0, 32). Can be done in place.
+        static void shift_digits_right(digit* result, const digit* x, const std::size_t size, const int bits)
+        {
+            for(std::size_t i = 0; i < size; i++)
+            {
+                const superdigit pair = (static_cast<superdigit>(i + 1 < size ? x[i + 1] : 0) << 32) | x[i];
+                result[i] = static_cast<digit>(pair >> bits);
+            }
+        }
+        // result = x * y with the schoolbook method (result has x_size + y_size digits and must not overlap the operands).
+        static void schoolbook_multiply(digit* result, const digit* x, const std::size_t x_size, const digit* y, const std::size_t y_size)
+        {
+            std::fill(result, result + x_size + y_size, 0);
+            for(std::size_t i = 0; i < y_size; i++)
+            {
+                result[i + x_size] = multiply_add_digit(result + i, x, x_size, y[i]);
+            }
+        }
+        // result = x * y (result has x_size + y_size digits and must not overlap the operands).
+        static void multiply_buffers(digit* result, const digit* x, std::size_t x_size, const digit* y, std::size_t y_size)
+        {
+            if(x_size < y_size)
+            {
+                std::swap(x, y);
+                std::swap(x_size, y_size);
+            }
+            if(y_size < karatsuba_threshold)
+            {
+                schoolbook_multiply(result, x, x_size, y, y_size);
+                return;
+            }
+            if(2 * y_size <= x_size)
+            {
+                // Unbalanced operands: multiply y with slices of x that are as long as y.
+                std::fill(result, result + x_size + y_size, 0);
+                digit_buffer partial(2 * y_size);
+                for(std::size_t i = 0; i < x_size; i += y_size)
+                {
+                    const std::size_t length = std::min(y_size, x_size - i);
+                    multiply_buffers(partial.data(), x + i, length, y, y_size);
+                    add_digits(result + i, x_size + y_size - i, partial.data(), length + y_size);
+                }
+                return;
+            }
+            karatsuba_multiply(result, x, x_size, y, y_size);
+        }
+        // Karatsuba multiplication, for x_size / 2 < y_size <= x_size.
+        static void karatsuba_multiply(digit* result, const digit* x, const std::size_t x_size, const digit* y, const std::size_t y_size)
+        {
+            // x = x1 * B^half + x0, y = y1 * B^half + y0 (B = 2^32).
+            const std::size_t half = (x_size + 1) / 2;
+            const std::size_t x1_size = x_size - half, y1_size = y_size - half;
+            const std::size_t high_size = x1_size + y1_size;
+            // x0 * y0 and x1 * y1 go straight into their places in the result.
+            multiply_buffers(result, x, half, y, half);
+            if(y1_size != 0)
+            {
+                multiply_buffers(result + 2 * half, x + half, x1_size, y + half, y1_size);
+            }
+            else
+            {
+                std::fill(result + 2 * half, result + 2 * half + high_size, 0);
+            }
+            // (x0 + x1) * (y0 + y1) - x0 * y0 - x1 * y1 is the middle term.
+            digit_buffer x_sum(x, x + half), y_sum(y, y + half);
+            x_sum.push_back(add_digits(x_sum.data(), half, x + half, x1_size));
+            y_sum.push_back(add_digits(y_sum.data(), half, y + half, y1_size));
+            digit_buffer middle(2 * half + 2);
+            multiply_buffers(middle.data(), x_sum.data(), half + 1, y_sum.data(), half + 1);
+            subtract_digits(middle.data(), middle.size(), result, 2 * half);
+            subtract_digits(middle.data(), middle.size(), result + 2 * half, high_size);
+            trim(middle);
+            assert(middle.size() <= x_size + y_size - half);
+            add_digits(result + half, x_size + y_size - half, middle.data(), middle.size());
+        }
+        // x * y for buffers (without leading zeroes).
+        static digit_buffer multiply_buffers(const digit_buffer& x, const digit_buffer& y)
+        {
+            if(x.empty() or y.empty())
+            {
+                return {};
+            }
+            digit_buffer result(x.size() + y.size());
+            multiply_buffers(result.data(), x.data(), x.size(), y.data(), y.size());
+            trim(result);
+            return result;
+        }
+        // result = x^2 with the schoolbook method, each cross product computed once and doubled (result has 2 size digits and must not
+        // overlap x).
+        static void schoolbook_square(digit* result, const digit* x, const std::size_t size)
+        {
+            std::fill(result, result + 2 * size, 0);
+            for(std::size_t i = 0; i + 1 < size; i++)
+            {
+                result[i + size] = multiply_add_digit(result + 2 * i + 1, x + i + 1, size - i - 1, x[i]);
+            }
+            shift_digits_left(result, result, 2 * size, 1);
+            // Add the squares on the diagonal.
+            superdigit carry = 0;
+            for(std::size_t i = 0; i < size; i++)
+            {
+                const superdigit square = multiply_digits(x[i], x[i]);
+                carry += static_cast<digit>(square) + static_cast<superdigit>(result[2 * i]);
+                result[2 * i] = static_cast<digit>(carry);
+                carry = (carry >> 32) + (square >> 32) + result[2 * i + 1];
+                result[2 * i + 1] = static_cast<digit>(carry);
+                carry >>= 32;
+            }
+        }
+        // result = x^2 (result has 2 size digits and must not overlap x), by Karatsuba's method with its three products being squares.
+        static void square_buffers(digit* result, const digit* x, const std::size_t size)
+        {
+            if(size < karatsuba_threshold)
+            {
+                schoolbook_square(result, x, size);
+                return;
+            }
+            // x = x1 * B^half + x0, so x^2 = x1^2 B^(2 half) + ((x0 + x1)^2 - x0^2 - x1^2) B^half + x0^2.
+            const std::size_t half = (size + 1) / 2, high_size = size - half;
+            square_buffers(result, x, half);
+            square_buffers(result + 2 * half, x + half, high_size);
+            digit_buffer sum(x, x + half);
+            sum.push_back(add_digits(sum.data(), half, x + half, high_size));
+            digit_buffer middle(2 * half + 2);
+            square_buffers(middle.data(), sum.data(), half + 1);
+            subtract_digits(middle.data(), middle.size(), result, 2 * half);
+            subtract_digits(middle.data(), middle.size(), result + 2 * half, 2 * high_size);
+            trim(middle);
+            add_digits(result + half, 2 * size - half, middle.data(), middle.size());
+        }
+        // x^2 for a buffer (without leading zeroes).
+        static digit_buffer square_buffers(const digit_buffer& x)
+        {
+            digit_buffer result(2 * x.size());
+            square_buffers(result.data(), x.data(), x.size());
+            trim(result);
+            return result;
+        }
+        // Divide buffers (without leading zeroes, y non-zero), picking the algorithm by the operand sizes.
+        static void divide_buffers(digit_buffer& quotient, digit_buffer& remainder, const digit_buffer& x, const digit_buffer& y)
+        {
+            assert(!y.empty());
+            if(x.size() < y.size())
+            {
+                quotient.clear();
+                remainder = x;
+                return;
+            }
+            const std::size_t quotient_size = x.size() - y.size() + 1;
+            if(y.size() >= burnikel_ziegler_threshold and quotient_size >= burnikel_ziegler_threshold)
+            {
+                burnikel_ziegler_divide(quotient, remainder, x, y);
+                return;
+            }
+            knuth_divide(quotient, remainder, x, y);
+        }
+        // x + y for buffers (without leading zeroes).
+        static digit_buffer add_buffers(const digit_buffer& x, const digit_buffer& y)
+        {
+            const digit_buffer& longer = x.size() >= y.size() ? x : y;
+            const digit_buffer& shorter = x.size() >= y.size() ? y : x;
+            digit_buffer result(longer);
+            result.push_back(add_digits(result.data(), longer.size(), shorter.data(), shorter.size()));
+            trim(result);
+            return result;
+        }
+        // x - y for buffers (without leading zeroes), where x is at least y.
+        static digit_buffer subtract_buffers(const digit_buffer& x, const digit_buffer& y)
+        {
+            assert(compare_buffers(x.data(), x.size(), y.data(), y.size()) >= 0);
+            digit_buffer result(x);
+            subtract_digits(result.data(), result.size(), y.data(), y.size());
+            trim(result);
+            return result;
+        }
+        // The lowest 'count' digits of a buffer (without leading zeroes).
+        static digit_buffer low_digits(const digit_buffer& x, const std::size_t count)
+        {
+            digit_buffer result(x.begin(), x.begin() + std::min(count, x.size()));
+            trim(result);
+            return result;
+        }
+        // The digits of a buffer above the lowest 'count' ones (x / B^count).
+        static digit_buffer high_digits(const digit_buffer& x, const std::size_t count)
+        {
+            return count < x.size() ? digit_buffer(x.begin() + count, x.end()) : digit_buffer();
+        }
+        // high * B^count + low, where low has at most 'count' digits.
+        static digit_buffer join_digits(const digit_buffer& high, const digit_buffer& low, const std::size_t count)
+        {
+            assert(low.size() <= count);
+            if(high.empty())
+            {
+                return low;
+            }
+            digit_buffer result(low);
+            result.resize(count, 0);
+            result.insert(result.end(), high.begin(), high.end());
+            return result;
+        }
+        // Burnikel-Ziegler recursive division of buffers (without leading zeroes, y non-zero).
+        // The divisor is padded to n = j * 2^k digits (j below the threshold), so that the recursion halves evenly down to long division.
+        static void burnikel_ziegler_divide(digit_buffer& quotient, digit_buffer& remainder, const digit_buffer& x, const digit_buffer& y)
+        {
+            std::size_t blocks_per_divisor = 1;
+            while(y.size() / blocks_per_divisor >= burnikel_ziegler_threshold)
+            {
+                blocks_per_divisor *= 2;
+            }
+            const std::size_t n = (y.size() + blocks_per_divisor - 1) / blocks_per_divisor * blocks_per_divisor;
+            // Shift both operands so that the divisor has exactly n digits and its top bit set.
+            const std::size_t padding = n - y.size();
+            const int shift = leading_zeros(y.back());
+            digit_buffer b(n, 0), a(x.size() + padding + 1, 0);
+            shift_digits_left(b.data() + padding, y.data(), y.size(), shift);
+            a.back() = shift_digits_left(a.data() + padding, x.data(), x.size(), shift);
+            trim(a);
+            // Split the dividend into n-digit blocks, the top one having its top bit clear, so that it is less than b.
+            std::size_t blocks = (a.size() + n - 1) / n;
+            if(!a.empty() and (a.size() % n == 0) and leading_zeros(a.back()) == 0)
+            {
+                blocks++;
+            }
+            blocks = std::max<std::size_t>(blocks, 2);
+            quotient.assign((blocks - 1) * n, 0);
+            digit_buffer z = high_digits(a, (blocks - 2) * n), block_quotient;
+            for(std::size_t i = blocks - 1; i-- > 0;)
+            {
+                divide_two_by_one(block_quotient, remainder, z, b, n);
+                std::copy(block_quotient.begin(), block_quotient.end(), quotient.begin() + i * n);
+                if(i > 0)
+                {
+                    z = join_digits(remainder, low_digits(high_digits(a, (i - 1) * n), n), n);
+                }
+            }
+            trim(quotient);
+            // Undo the shift on the remainder.
+            remainder = high_digits(remainder, padding);
+            shift_digits_right(remainder.data(), remainder.data(), remainder.size(), shift);
+            trim(remainder);
+        }
+        // Divide a 2n-digit a by an n-digit normalized b, where a < b * B^n.
+        static void divide_two_by_one(digit_buffer& quotient, digit_buffer& remainder, const digit_buffer& a, const digit_buffer& b, const std::size_t n)
+        {
+            if(n % 2 != 0 or n < burnikel_ziegler_threshold)
+            {
+                knuth_divide(quotient, remainder, a, b);
+                return;
+            }
+            // With a = [a1, a2, a3, a4] in n/2-digit pieces: [a1, a2, a3] / b, then [r1, a4] / b.
+            const std::size_t half = n / 2;
+            digit_buffer high_quotient, low_quotient, high_remainder;
+            divide_three_by_two(high_quotient, high_remainder, high_digits(a, half), b, half);
+            divide_three_by_two(low_quotient, remainder, join_digits(high_remainder, low_digits(a, half), half), b, half);
+            quotient = join_digits(high_quotient, low_quotient, half);
+        }
+        // Divide a 3n-digit a by a 2n-digit normalized b, where a < b * B^n.
+        static void divide_three_by_two(digit_buffer& quotient, digit_buffer& remainder, const digit_buffer& a, const digit_buffer& b, const std::size_t n)
+        {
+            const digit_buffer b1 = high_digits(b, n), b2 = low_digits(b, n);
+            const digit_buffer a12 = high_digits(a, n), a1 = high_digits(a, 2 * n);
+            // Estimate the quotient from the top digits of both, which is at most 2 too large.
+            digit_buffer c;
+            if(compare_buffers(a1.data(), a1.size(), b1.data(), b1.size()) < 0)
+            {
+                divide_two_by_one(quotient, c, a12, b1, n);
+            }
+            else
+            {
+                // The quotient is B^n - 1, and c = a12 - (B^n - 1) * b1.
+                quotient.assign(n, max_digit);
+                c = subtract_buffers(add_buffers(a12, b1), join_digits(b1, {}, n));
+            }
+            const digit_buffer d = multiply_buffers(quotient, b2);
+            remainder = join_digits(c, low_digits(a, n), n);
+            while(compare_buffers(remainder.data(), remainder.size(), d.data(), d.size()) < 0)
+            {
+                const digit unit = 1;
+                subtract_digits(quotient.data(), quotient.size(), &unit, 1);
+                remainder = add_buffers(remainder, b);
+            }
+            trim(quotient);
+            remainder = subtract_buffers(remainder, d);
+        }
+        // x / y for buffers (without leading zeroes), where y is known to divide x.
+        static digit_buffer divide_exact_buffers(digit_buffer x, digit_buffer y)
+        {
+            assert(!y.empty());
+            // Strip the trailing zeroes of y (and the same ones of x), so that its lowest digit is odd, hence invertible mod B.
+            std::size_t zero_digits = 0;
+            while(y[zero_digits] == 0)
+            {
+                zero_digits++;
+            }
+            x = high_digits(x, zero_digits);
+            y = high_digits(y, zero_digits);
+            const int zero_bits = trailing_zeros(y[0]);
+            shift_digits_right(x.data(), x.data(), x.size(), zero_bits);
+            shift_digits_right(y.data(), y.data(), y.size(), zero_bits);
+            trim(x);
+            trim(y);
+            if(x.size() < y.size())
+            {
+                return {};
+            }
+            const std::size_t size = x.size() - y.size() + 1;
+            if(size < bidirectional_exact_division_threshold)
+            {
+                return hensel_divide(x, y, size);
+            }
+            // Bidirectional: the low half of the quotient by Hensel division, the high half by ordinary division of the top digits,
+            // the two overlapping by one digit, which settles the last unit of the (truncated) high half.
+            const std::size_t low_size = (size + 1) / 2, high_size = size - low_size + 1;
+            const digit_buffer low = hensel_divide(low_digits(x, low_size), low_digits(y, low_size), low_size);
+            const std::size_t kept = std::min(y.size(), high_size + 2), dropped = y.size() - kept;
+            digit_buffer high, remainder;
+            divide_buffers(high, remainder, high_digits(x, dropped + low_size - 1), high_digits(y, dropped));
+            const digit overlap = low_size - 1 < low.size() ? low[low_size - 1] : 0;
+            const auto error = static_cast<std::int32_t>((high.empty() ? 0 : high[0]) - overlap);
+            if(error > 0)
+            {
+                const digit e = static_cast<digit>(error);
+                subtract_digits(high.data(), high.size(), &e, 1);
+            }
+            else if(error < 0)
+            {
+                const digit e = static_cast<digit>(-static_cast<std::int64_t>(error));
+                high.push_back(0);
+                add_digits(high.data(), high.size(), &e, 1);
+            }
+            trim(high);
+            return join_digits(high, low_digits(low, low_size - 1), low_size - 1);
+        }
+        // x / y mod B^size for buffers, where y is odd and divides x: Hensel division, cancelling the digits of x from the bottom.
+        static digit_buffer hensel_divide(digit_buffer x, const digit_buffer& y, const std::size_t size)
+        {
+            assert(!y.empty() and y[0] % 2 != 0);
+            x.resize(std::max(x.size(), size), 0);
+            // y^-1 mod B, by Newton's iteration (y * y = 1 mod 8 already gives 3 correct bits, each step doubles them).
+            digit inverse = y[0];
+            for(int i = 0; i < 4; i++)
+            {
+                inverse *= 2 - y[0] * inverse;
+            }
+            digit_buffer quotient(size);
+            for(std::size_t i = 0; i < size; i++)
+            {
+                // Only the digits below 'size' matter, the ones above cancel out.
+                const digit q = x[i] * inverse;
+                quotient[i] = q;
+                const std::size_t span = std::min(y.size(), size - i);
+                superdigit borrow = multiply_subtract_digit(x.data() + i, y.data(), span, q);
+                for(std::size_t j = i + span; borrow != 0 and j < size; j++)
+                {
+                    const bool is_underflow = x[j] < borrow;
+                    x[j] = static_cast<digit>(x[j] - borrow);
+                    borrow = is_underflow ? 1 : 0;
+                }
+            }
+            trim(quotient);
+            return quotient;
+        }
+        // Long division of buffers (without leading zeroes, y non-zero), Knuth's algorithm D.
+        static void knuth_divide(digit_buffer& quotient, digit_buffer& remainder, const digit_buffer& x, const digit_buffer& y)
+        {
+            assert(!y.empty() and y.back() != 0);
+            const std::size_t n = y.size(), m = x.size();
+            if(m < n)
+            {
+                quotient.clear();
+                remainder = x;
+                return;
+            }
+            quotient.assign(m - n + 1, 0);
+            if(n == 1)
+            {
+                superdigit carry = 0;
+                for(std::size_t i = m; i-- > 0;)
+                {
+                    carry = (carry << 32) | x[i];
+                    quotient[i] = static_cast<digit>(carry / y[0]);
+                    carry %= y[0];
+                }
+                trim(quotient);
+                remainder.assign(1, static_cast<digit>(carry));
+                trim(remainder);
+                return;
+            }
+            // Normalize, so that the top bit of the divisor is set and each quotient digit estimate is off by at most 2.
+            const int shift = leading_zeros(y.back());
+            digit_buffer v(n), u(m + 1);
+            shift_digits_left(v.data(), y.data(), n, shift);
+            u[m] = shift_digits_left(u.data(), x.data(), m, shift);
+            for(std::size_t j = m - n + 1; j-- > 0;)
+            {
+                // Estimate the quotient digit from the top two digits of the remainder and the top digit of the divisor.
+                const superdigit numerator = (static_cast<superdigit>(u[j + n]) << 32) | u[j + n - 1];
+                superdigit estimate = numerator / v[n - 1];
+                superdigit estimate_remainder = numerator % v[n - 1];
+                while(estimate > max_digit or estimate * v[n - 2] > ((estimate_remainder << 32) | u[j + n - 2]))
+                {
+                    estimate--;
+                    estimate_remainder += v[n - 1];
+                    if(estimate_remainder > max_digit)
+                    {
+                        break;
+                    }
+                }
+                // Multiply and subtract, adding back in the rare case the estimate was still one too large.
+                const superdigit borrow = multiply_subtract_digit(u.data() + j, v.data(), n, static_cast<digit>(estimate));
+                const bool is_overshoot = u[j + n] < borrow;
+                u[j + n] = static_cast<digit>(u[j + n] - borrow);
+                if(is_overshoot)
+                {
+                    estimate--;
+                    u[j + n] += add_digits(u.data() + j, n, v.data(), n);
+                }
+                quotient[j] = static_cast<digit>(estimate);
+            }
+            trim(quotient);
+            remainder.resize(n);
+            shift_digits_right(remainder.data(), u.data(), n, shift);
+            trim(remainder);
+        }
+        // floor(B^(2n) / d) for a normalized (top bit set) n-digit divisor d, where B = 2^32. Computed by Newton's iteration,
+        // doubling the precision at each step and approaching from below, so that only a few final corrections are needed.
+        static digit_buffer newton_reciprocal(const digit* d, const std::size_t n)
+        {
+            assert(n > 0 and leading_zeros(d[n - 1]) == 0);
+            digit_buffer divisor(d, d + n);
+            if(n < reciprocal_threshold)
+            {
+                digit_buffer power(2 * n + 1, 0), reciprocal, remainder;
+                power.back() = 1;
+                divide_buffers(reciprocal, remainder, power, divisor);
+                return reciprocal;
+            }
+            // The reciprocal of the top half of the divisor, with a margin that makes it an underestimate for the whole divisor.
+            const std::size_t high = (n + 1) / 2, low = n - high;
+            digit_buffer approximation = newton_reciprocal(d + low, high);
+            const digit margin = 4;
+            subtract_digits(approximation.data(), approximation.size(), &margin, 1);
+            trim(approximation);
+            // error = B^(n + high) - d * approximation, the scaled error of the approximation (non-negative).
+            digit_buffer error(n + approximation.size());
+            multiply_buffers(error.data(), d, n, approximation.data(), approximation.size());
+            error.resize(n + high);
+            for(digit& e : error)
+            {
+                e = ~e;
+            }
+            const digit unit = 1;
+            add_digits(error.data(), error.size(), &unit, 1);
+            trim(error);
+            // Newton step: correction = approximation * error / B^(2 * high). This only needs the high part of the product,
+            // so it is computed as a short product that skips the low digits of the error.
+            const std::size_t skipped = std::min(high >= 2 ? high - 2 : 0, error.size());
+            digit_buffer correction(error.size() - skipped + approximation.size());
+            multiply_buffers(correction.data(), error.data() + skipped, error.size() - skipped, approximation.data(), approximation.size());
+            correction.erase(correction.begin(), correction.begin() + std::min(correction.size(), 2 * high - skipped));
+            trim(correction);
+            // reciprocal = approximation * B^low + correction.
+            digit_buffer reciprocal(n + 2, 0);
+            std::copy(approximation.begin(), approximation.end(), reciprocal.begin() + low);
+            add_digits(reciprocal.data(), reciprocal.size(), correction.data(), correction.size());
+            // remainder = B^(2n) - d * reciprocal = error * B^low - d * correction, then fix up the last units.
+            digit_buffer remainder(low, 0);
+            remainder.insert(remainder.end(), error.begin(), error.end());
+            remainder.resize(std::max(remainder.size(), n + correction.size()) + 1, 0);
+            if(!correction.empty())
+            {
+                digit_buffer product(n + correction.size());
+                multiply_buffers(product.data(), d, n, correction.data(), correction.size());
+                const digit borrow = subtract_digits(remainder.data(), remainder.size(), product.data(), product.size());
+                assert(borrow == 0);
+                (void)borrow;
+            }
+            trim(remainder);
+            while(compare_buffers(remainder.data(), remainder.size(), divisor.data(), n) >= 0)
+            {
+                add_digits(reciprocal.data(), reciprocal.size(), &unit, 1);
+                subtract_digits(remainder.data(), remainder.size(), divisor.data(), n);
+                trim(remainder);
+            }
+            trim(reciprocal);
+            return reciprocal;
+        }
+        // Divide x by a normalized divisor (shifted left by 'shift' bits) using its precomputed reciprocal floor(B^(2n) / d).
+        // The dividend is consumed n digits at a time, each block costing two multiplications instead of n^2 digit operations.
+        static void newton_divide(digit_buffer& quotient, digit_buffer& remainder, const digit_buffer& x, const digit_buffer& d, const digit_buffer& inverse, const int shift)
+        {
+            const std::size_t n = d.size();
+            digit_buffer u(x.size() + 1);
+            u[x.size()] = shift_digits_left(u.data(), x.data(), x.size(), shift);
+            trim(u);
+            if(u.size() < n)
+            {
+                quotient.clear();
+                remainder = x;
+                return;
+            }
+            // The top n digits start off the running remainder if they are less than d, otherwise the top n - 1 digits do.
+            std::size_t position = u.size() - n;
+            if(compare_buffers(u.data() + position, n, d.data(), n) >= 0)
+            {
+                position++;
+            }
+            // The running remainder (less than d) goes on top, the next block of the dividend below it.
+            digit_buffer chunk(2 * n + 1, 0);
+            std::copy(u.begin() + position, u.end(), chunk.begin() + n);
+            quotient.assign(position, 0);
+            digit_buffer estimate_product(2 * n + 2), product(2 * n + 1), block_quotient, block_remainder;
+            while(position > 0)
+            {
+                const std::size_t size = std::min(n, position);
+                position -= size;
+                // Shift the remainder down to sit right above the block.
+                std::copy(chunk.begin() + n, chunk.begin() + 2 * n, chunk.begin() + size);
+                std::fill(chunk.begin() + size + n, chunk.end(), 0);
+                std::copy(u.begin() + position, u.begin() + position + size, chunk.begin());
+                if(4 * size < n)
+                {
+                    // A short block is cheaper to finish with long division.
+                    digit_buffer dividend(chunk.begin(), chunk.begin() + size + n);
+                    trim(dividend);
+                    knuth_divide(block_quotient, block_remainder, dividend, d);
+                    std::copy(block_quotient.begin(), block_quotient.end(), quotient.begin() + position);
+                    std::fill(chunk.begin() + n, chunk.end(), 0);
+                    std::copy(block_remainder.begin(), block_remainder.end(), chunk.begin() + n);
+                    continue;
+                }
+                // estimate = floor(floor(chunk / B^(n - 1)) * inverse / B^(n + 1)), which is at most 2 below the true quotient.
+                multiply_buffers(estimate_product.data(), chunk.data() + n - 1, size + 1, inverse.data(), inverse.size());
+                digit_buffer estimate(estimate_product.begin() + n + 1, estimate_product.begin() + size + 1 + inverse.size());
+                trim(estimate);
+                if(!estimate.empty())
+                {
+                    multiply_buffers(product.data(), d.data(), n, estimate.data(), estimate.size());
+                    std::size_t product_size = n + estimate.size();
+                    while(product[product_size - 1] == 0)
+                    {
+                        product_size--;
+                    }
+                    assert(product_size <= size + n);
+                    const digit borrow = subtract_digits(chunk.data(), size + n, product.data(), product_size);
+                    assert(borrow == 0);
+                    (void)borrow;
+                }
+                estimate.resize(size + 1, 0);
+                while(chunk[n] != 0 or compare_buffers(chunk.data(), n, d.data(), n) >= 0)
+                {
+                    const digit unit = 1;
+                    add_digits(estimate.data(), estimate.size(), &unit, 1);
+                    subtract_digits(chunk.data(), n + 1, d.data(), n);
+                }
+                assert(estimate[size] == 0);
+                std::copy(estimate.begin(), estimate.begin() + size, quotient.begin() + position);
+                // Move the remainder back on top.
+                std::copy_backward(chunk.begin(), chunk.begin() + n, chunk.begin() + 2 * n);
+            }
+            trim(quotient);
+            remainder.assign(chunk.begin() + n, chunk.begin() + 2 * n);
+            shift_digits_right(remainder.data(), remainder.data(), n, shift);
+            trim(remainder);
+        }
+        // Greatest common divisor of two words, by the binary algorithm.
+        static superdigit binary_gcd(superdigit x, superdigit y)
+        {
+            if(x == 0 or y == 0)
+            {
+                return x | y;
+            }
+            const int shift = trailing_zeros(x | y);
+            x >>= trailing_zeros(x);
+            do
+            {
+                y >>= trailing_zeros(y);
+                if(x > y)
+                {
+                    std::swap(x, y);
+                }
+                y -= x;
+            }
+            while(y != 0);
+            return x << shift;
+        }
+        // The inverse of x modulo an odd word m above 1, for x below m, by the binary algorithm (returns whether there is one). The
+        // invariants are u = x1 x and v = x2 x modulo m.
+        static bool binary_inverse(const superdigit x, const superdigit m, superdigit& inverse)
+        {
+            superdigit u = x, v = m, x1 = 1, x2 = 0;
+            // value / 2 modulo m, without overflowing when m is close to 2^64.
+            const auto halve = [m](const superdigit value)
+            {
+                return value % 2 == 0 ? value / 2 : value / 2 + m / 2 + 1;
+            };
+            while(u != 1 and v != 1)
+            {
+                if(u == 0)
+                {
+                    return false;
+                }
+                for(; u % 2 == 0; u /= 2)
+                {
+                    x1 = halve(x1);
+                }
+                for(; v % 2 == 0; v /= 2)
+                {
+                    x2 = halve(x2);
+                }
+                if(u >= v)
+                {
+                    u -= v;
+                    x1 = x1 >= x2 ? x1 - x2 : x1 + (m - x2);
+                }
+                else
+                {
+                    v -= u;
+                    x2 = x2 >= x1 ? x2 - x1 : x2 + (m - x1);
+                }
+            }
+            inverse = u == 1 ? x1 : x2;
+            return true;
+        }
+        // 'count' (at most 64) bits of x from bit 'start'.
+        static superdigit buffer_bits(const digit_buffer& x, const std::size_t start, const int count)
+        {
+            superdigit result = 0;
+            for(std::size_t i = start / 32; i < x.size() and i <= (start + count - 1) / 32; i++)
+            {
+                const std::size_t position = 32 * i;
+                result |= position < start ? x[i] >> (start - position) : static_cast<superdigit>(x[i]) << (position - start);
+            }
+            return count == 64 ? result : result & ((superdigit(1) << count) - 1);
+        }
+        // Largest magnitude of the cofactors of a Lehmer step, which keeps the products of a cofactor and a digit within a signed word.
+        static constexpr int64_t lehmer_cofactor_limit = (int64_t(1) << 31) - 1;
+        // Lehmer's step (Knuth's algorithm L) on the top 62 bits of x and y, where x is at least y: the cofactors of as many steps of
+        // Euclid's algorithm as the top bits determine, as the matrix {{a, b}, {c, d}} (b is 0 if there are none). The quotients of
+        // the steps are appended to 'quotients' if given.
+        static void lehmer_cofactors(const digit_buffer& x, const digit_buffer& y, int64_t& a, int64_t& b, int64_t& c, int64_t& d,
+                                     std::vector<superdigit>* quotients = nullptr)
+        {
+            const std::size_t start = 32 * x.size() - leading_zeros(x.back()) - 62;
+            int64_t x_top = static_cast<int64_t>(buffer_bits(x, start, 62)), y_top = static_cast<int64_t>(buffer_bits(y, start, 62));
+            a = 1, b = 0, c = 0, d = 1;
+            const auto fits = [](const int64_t p, const int64_t q, const int64_t quotient)
+            {
+                return q == 0 or quotient <= (lehmer_cofactor_limit - (p < 0 ? -p : p)) / (q < 0 ? -q : q);
+            };
+            while(y_top + c != 0 and y_top + d != 0)
+            {
+                // The quotient is right if it is the same for both ends of the interval the top bits leave.
+                const int64_t quotient = (x_top + a) / (y_top + c);
+                if(quotient != (x_top + b) / (y_top + d) or !fits(a, c, quotient) or !fits(b, d, quotient))
+                {
+                    break;
+                }
+                if(quotients != nullptr)
+                {
+                    quotients->push_back(static_cast<superdigit>(quotient));
+                }
+                int64_t t = a - quotient * c;
+                a = c, c = t;
+                t = b - quotient * d;
+                b = d, d = t;
+                t = x_top - quotient * y_top;
+                x_top = y_top, y_top = t;
+            }
+        }
+        // x, y = a x + b y, c x + d y in place, in a single pass, where the results are non-negative and the entries of each row have
+        // opposite signs.
+        static void apply_cofactors(digit_buffer& x, digit_buffer& y, const int64_t a, const int64_t b, const int64_t c, const int64_t d)
+        {
+            y.resize(x.size(), 0);
+            int64_t x_carry = 0, y_carry = 0;
+            for(std::size_t i = 0; i < x.size(); i++)
+            {
+                const int64_t x_digit = x[i], y_digit = y[i];
+                const int64_t x_sum = a * x_digit + b * y_digit + x_carry, y_sum = c * x_digit + d * y_digit + y_carry;
+                x[i] = static_cast<digit>(x_sum);
+                y[i] = static_cast<digit>(y_sum);
+                // Exact divisions, so that the carries are floored without relying on the shift of negative values.
+                x_carry = (x_sum - static_cast<int64_t>(x[i])) / (int64_t(1) << 32);
+                y_carry = (y_sum - static_cast<int64_t>(y[i])) / (int64_t(1) << 32);
+            }
+            assert(x_carry == 0 and y_carry == 0);
+            trim(x);
+            trim(y);
+        }
+        // Greatest common divisor of buffers, by Lehmer's algorithm, with a division step where the top bits do not determine one,
+        // and the binary algorithm once both fit a word.
+        static digit_buffer gcd_buffers(digit_buffer x, digit_buffer y)
+        {
+            digit_buffer quotient, remainder;
+            if(compare_buffers(x.data(), x.size(), y.data(), y.size()) < 0)
+            {
+                std::swap(x, y);
+            }
+            while(!y.empty())
+            {
+                if(compare_buffers(x.data(), x.size(), y.data(), y.size()) < 0)
+                {
+                    std::swap(x, y);
+                }
+                if(x.size() >= subquadratic_gcd_threshold)
+                {
+                    quotient_matrix matrix;
+                    std::vector<digit_buffer> half_quotients;
+                    half_gcd(x, y, x.size() / 2, matrix, half_quotients);
+                    if(half_quotients.empty())
+                    {
+                        divide_buffers(quotient, remainder, x, y);
+                        std::swap(x, y);
+                        std::swap(y, remainder);
+                    }
+                    continue;
+                }
+                if(x.size() <= 2)
+                {
+                    const superdigit result = binary_gcd(buffer_bits(x, 0, 64), buffer_bits(y, 0, 64));
+                    return {static_cast<digit>(result), static_cast<digit>(result >> 32)};
+                }
+                int64_t a = 1, b = 0, c = 0, d = 1;
+                if(x.size() - y.size() <= 1)
+                {
+                    lehmer_cofactors(x, y, a, b, c, d);
+                }
+                if(b != 0)
+                {
+                    apply_cofactors(x, y, a, b, c, d);
+                }
+                else
+                {
+                    divide_buffers(quotient, remainder, x, y);
+                    std::swap(x, y);
+                    std::swap(y, remainder);
+                }
+            }
+            return x;
+        }
+        // The product of the matrices {{q, 1}, {1, 0}} of the quotients q of a run of Euclid's algorithm, which takes the last pair of
+        // remainders back to the first.
+        struct quotient_matrix
+        {
+            // Entries, row by row (the identity by default).
+            digit_buffer entries[2][2] = {{{1}, {}}, {{}, {1}}};
+            // Is the number of quotients odd (the determinant -1)?
+            bool is_odd = false;
+        };
+        // matrix = matrix * {{q, 1}, {1, 0}}.
+        static void push_quotient(quotient_matrix& matrix, const digit_buffer& q)
+        {
+            for(auto& row : matrix.entries)
+            {
+                digit_buffer first = add_buffers(multiply_buffers(row[0], q), row[1]);
+                row[1] = std::move(row[0]);
+                row[0] = std::move(first);
+            }
+            matrix.is_odd = !matrix.is_odd;
+        }
+        // matrix = matrix * {{q, 1}, {1, 0}}^-1, undoing the last quotient.
+        static void pop_quotient(quotient_matrix& matrix, const digit_buffer& q)
+        {
+            for(auto& row : matrix.entries)
+            {
+                digit_buffer second = subtract_buffers(row[0], multiply_buffers(row[1], q));
+                row[0] = std::move(row[1]);
+                row[1] = std::move(second);
+            }
+            matrix.is_odd = !matrix.is_odd;
+        }
+        static quotient_matrix multiply_matrices(const quotient_matrix& x, const quotient_matrix& y)
+        {
+            quotient_matrix result;
+            for(int i = 0; i < 2; i++)
+            {
+                for(int j = 0; j < 2; j++)
+                {
+                    result.entries[i][j] = add_buffers(multiply_buffers(x.entries[i][0], y.entries[0][j]),
+                                                       multiply_buffers(x.entries[i][1], y.entries[1][j]));
+                }
+            }
+            result.is_odd = x.is_odd xor y.is_odd;
+            return result;
+        }
+        // The pair of remainders (first, second) that the matrix takes to (x, y) = (top_x B^low + low_x, top_y B^low + low_y), given
+        // those it takes (top_x, top_y) to, unless one of them would be negative (returns whether they are not). Only the low digits
+        // are multiplied.
+        static bool apply_inverse(const quotient_matrix& matrix, const digit_buffer& top_first, const digit_buffer& top_second,
+                                  const digit_buffer& low_x, const digit_buffer& low_y, const std::size_t low, digit_buffer& first,
+                                  digit_buffer& second)
+        {
+            // The inverse is {{d, -b}, {-c, a}}, negated if the determinant is -1.
+            const auto combine = [&matrix, low](const digit_buffer& top, const digit_buffer& positive, const digit_buffer& negative,
+                                                digit_buffer& result)
+            {
+                result = add_buffers(join_digits(top, digit_buffer(), low), matrix.is_odd ? negative : positive);
+                const digit_buffer& subtrahend = matrix.is_odd ? positive : negative;
+                if(compare_buffers(result.data(), result.size(), subtrahend.data(), subtrahend.size()) < 0)
+                {
+                    return false;
+                }
+                result = subtract_buffers(result, subtrahend);
+                return true;
+            };
+            return combine(top_first, multiply_buffers(matrix.entries[1][1], low_x), multiply_buffers(matrix.entries[0][1], low_y), first)
+                   and combine(top_second, multiply_buffers(matrix.entries[0][0], low_y), multiply_buffers(matrix.entries[1][0], low_x),
+                               second);
+        }
+        // Do the quotients that take (x, y) to the consecutive remainders (first, second) (as in the matrix) also leave consecutive
+        // non-zero remainders for (x + 1, y) and (x, y + 1)? The remainders of those differ by a column of the inverse of the matrix.
+        static bool is_shared_by_neighbours(const quotient_matrix& matrix, const digit_buffer& first, const digit_buffer& second)
+        {
+            // first + entry if 'add', else first - entry, which must be positive.
+            const auto offset = [](const digit_buffer& value, const digit_buffer& entry, const bool add, digit_buffer& result)
+            {
+                if(add)
+                {
+                    result = add_buffers(value, entry);
+                    return true;
+                }
+                if(compare_buffers(value.data(), value.size(), entry.data(), entry.size()) <= 0)
+                {
+                    return false;
+                }
+                result = subtract_buffers(value, entry);
+                return true;
+            };
+            const auto is_consecutive = [](const digit_buffer& x, const digit_buffer& y)
+            {
+                return !y.empty() and compare_buffers(y.data(), y.size(), x.data(), x.size()) < 0;
+            };
+            const bool is_even = !matrix.is_odd;
+            digit_buffer x_first, x_second, y_first, y_second;
+            return offset(first, matrix.entries[1][1], is_even, x_first) and offset(second, matrix.entries[1][0], !is_even, x_second)
+                   and is_consecutive(x_first, x_second) and offset(first, matrix.entries[0][1], !is_even, y_first)
+                   and offset(second, matrix.entries[0][0], is_even, y_second) and is_consecutive(y_first, y_second);
+        }
+        // (first, second) = (first p00 + second p10, first p01 + second p11) in a single pass, for entries below 2^31 (so that the
+        // sums of products cannot overflow a word).
+        static void multiply_row(digit_buffer& first, digit_buffer& second, const digit p00, const digit p01, const digit p10,
+                                 const digit p11)
+        {
+            const std::size_t size = std::max(first.size(), second.size());
+            first.resize(size + 1, 0);
+            second.resize(size + 1, 0);
+            superdigit first_carry = 0, second_carry = 0;
+            for(std::size_t i = 0; i <= size; i++)
+            {
+                const superdigit x = first[i], y = second[i];
+                first_carry += x * p00 + y * p10;
+                second_carry += x * p01 + y * p11;
+                first[i] = static_cast<digit>(first_carry);
+                second[i] = static_cast<digit>(second_carry);
+                first_carry >>= 32;
+                second_carry >>= 32;
+            }
+            trim(first);
+            trim(second);
+        }
+        // Undo the last step of Euclid's algorithm, (x, y) = (q x + y, x).
+        static void step_back(digit_buffer& x, digit_buffer& y, quotient_matrix& matrix, std::vector<digit_buffer>& quotients)
+        {
+            const digit_buffer& q = quotients.back();
+            digit_buffer previous = add_buffers(multiply_buffers(q, x), y);
+            y = std::move(x);
+            x = std::move(previous);
+            pop_quotient(matrix, q);
+            quotients.pop_back();
+        }
+        // One step of Euclid's algorithm, (x, y) = (y, x mod y).
+        static void euclid_step(digit_buffer& x, digit_buffer& y, quotient_matrix& matrix, std::vector<digit_buffer>& quotients)
+        {
+            digit_buffer quotient, remainder;
+            divide_buffers(quotient, remainder, x, y);
+            push_quotient(matrix, quotient);
+            quotients.push_back(std::move(quotient));
+            x = std::move(y);
+            y = std::move(remainder);
+        }
+        // Continue Euclid's algorithm on (x, y), where x is at least y, until y is below B^size (x being at least that), with Lehmer
+        // steps while y is well above it. The quotients are appended to 'quotients' and their matrices multiplied into 'matrix'.
+        static void euclid_reduce(digit_buffer& x, digit_buffer& y, const std::size_t size, quotient_matrix& matrix,
+                                  std::vector<digit_buffer>& quotients)
+        {
+            std::vector<superdigit> lehmer_quotients;
+            while(y.size() > size)
+            {
+                int64_t a = 1, b = 0, c = 0, d = 1;
+                lehmer_quotients.clear();
+                if(y.size() > size + 2 and x.size() > 2 and x.size() - y.size() <= 1)
+                {
+                    lehmer_cofactors(x, y, a, b, c, d, &lehmer_quotients);
+                }
+                if(b == 0)
+                {
+                    euclid_step(x, y, matrix, quotients);
+                    continue;
+                }
+                apply_cofactors(x, y, a, b, c, d);
+                // The cofactors are the inverse of the product of the quotient matrices, up to the sign of each entry.
+                const auto entry = [](const int64_t value)
+                {
+                    return static_cast<digit>(value < 0 ? -value : value);
+                };
+                for(auto& row : matrix.entries)
+                {
+                    multiply_row(row[0], row[1], entry(d), entry(b), entry(c), entry(a));
+                }
+                matrix.is_odd = matrix.is_odd xor (lehmer_quotients.size() % 2 != 0);
+                for(const superdigit q : lehmer_quotients)
+                {
+                    quotients.push_back({static_cast<digit>(q), static_cast<digit>(q >> 32)});
+                    trim(quotients.back());
+                }
+            }
+            // A Lehmer step may have gone past B^size, in which case it is stepped back.
+            while(x.size() <= size and !quotients.empty())
+            {
+                step_back(x, y, matrix, quotients);
+            }
+        }
+        // The half-gcd algorithm: Euclid's algorithm on (x, y), where x is at least y, until y is below B^size, in place, with the
+        // quotients and their matrix (which start afresh). The quotients are found recursively from the top digits, about half of the
+        // remaining reduction at a time, and checked against the full values, stepping back the few the top digits may get wrong.
+        static void half_gcd(digit_buffer& x, digit_buffer& y, const std::size_t size, quotient_matrix& matrix,
+                             std::vector<digit_buffer>& quotients)
+        {
+            matrix = quotient_matrix();
+            quotients.clear();
+            if(y.size() <= size)
+            {
+                return;
+            }
+            if(x.size() - size < half_gcd_threshold)
+            {
+                euclid_reduce(x, y, size, matrix, quotients);
+                return;
+            }
+            // Reduce by the half-gcd of the digits above 'low', checked against the full values.
+            const auto reduce_top = [&](const std::size_t low, const std::size_t top_size)
+            {
+                digit_buffer top_x = high_digits(x, low), top_y = high_digits(y, low);
+                quotient_matrix top_matrix;
+                std::vector<digit_buffer> top_quotients;
+                half_gcd(top_x, top_y, top_size, top_matrix, top_quotients);
+                // x / y is between the top digits of x over those of y plus one and the other way around, so the quotients of both of
+                // those hold for it. This is checked on the small values, stepping back until it holds.
+                while(!top_quotients.empty() and !is_shared_by_neighbours(top_matrix, top_x, top_y))
+                {
+                    step_back(top_x, top_y, top_matrix, top_quotients);
+                }
+                // The quotients are right if they leave consecutive remainders, other than the ones of ending on a quotient of 1, which
+                // is the same as adding it to the one before.
+                const auto is_right = [&](const digit_buffer& first, const digit_buffer& second)
+                {
+                    return first.size() > size and compare_buffers(second.data(), second.size(), first.data(), first.size()) < 0
+                           and !(second.empty() and top_quotients.size() > 1 and top_quotients.back() == digit_buffer{1});
+                };
+                const digit_buffer low_x = low_digits(x, low), low_y = low_digits(y, low);
+                digit_buffer first, second;
+                while(!top_quotients.empty())
+                {
+                    if(apply_inverse(top_matrix, top_x, top_y, low_x, low_y, low, first, second) and is_right(first, second))
+                    {
+                        x = std::move(first);
+                        y = std::move(second);
+                        matrix = multiply_matrices(matrix, top_matrix);
+                        std::move(top_quotients.begin(), top_quotients.end(), std::back_inserter(quotients));
+                        return;
+                    }
+                    step_back(top_x, top_y, top_matrix, top_quotients);
+                }
+            };
+            // The top 'excess' digits are reduced to about half, which takes the full values down by as much.
+            const std::size_t excess = x.size() - size;
+            reduce_top(size, excess / 2 + 1);
+            if(y.size() > size)
+            {
+                euclid_step(x, y, matrix, quotients);
+            }
+            // The rest of the reduction, from the top twice as many digits as it needs.
+            if(y.size() > size and x.size() > size)
+            {
+                const std::size_t rest = x.size() - size, low = size > rest ? size - rest : 0;
+                reduce_top(low, size - low);
+            }
+            euclid_reduce(x, y, size, matrix, quotients);
+        }
+        // Euclid's algorithm on (x, y), where x is at least y, down to (gcd, 0), with the quotients and their matrix if asked for.
+        static void gcd_quotients(digit_buffer& x, digit_buffer& y, quotient_matrix* matrix, std::vector<digit_buffer>* quotients)
+        {
+            while(!y.empty())
+            {
+                quotient_matrix step_matrix;
+                std::vector<digit_buffer> step_quotients;
+                if(x.size() < subquadratic_gcd_threshold)
+                {
+                    euclid_reduce(x, y, 0, step_matrix, step_quotients);
+                }
+                else
+                {
+                    half_gcd(x, y, x.size() / 2, step_matrix, step_quotients);
+                    if(step_quotients.empty())
+                    {
+                        euclid_step(x, y, step_matrix, step_quotients);
+                    }
+                }
+                if(matrix != nullptr)
+                {
+                    *matrix = multiply_matrices(*matrix, step_matrix);
+                }
+                if(quotients != nullptr)
+                {
+                    std::move(step_quotients.begin(), step_quotients.end(), std::back_inserter(*quotients));
+                }
+            }
+        }
+        // (first, second) = (second, first + q second), the cofactors of a step of Euclid's algorithm with quotient q.
+        static void step_cofactors(digit_buffer& first, digit_buffer& second, const digit_buffer& q)
+        {
+            if(q.size() == 1 and q[0] <= lehmer_cofactor_limit)
+            {
+                multiply_row(first, second, 0, 1, 1, q[0]);
+                return;
+            }
+            digit_buffer next = add_buffers(first, multiply_buffers(second, q));
+            first = std::move(second);
+            second = std::move(next);
+        }
+        // Greatest common divisor of x and y, where x is at least y and y is not 0, with the cofactor t of y such that s x + t y is
+        // the gcd (its magnitude, and whether it is negative). The cofactors of the remainders are updated in place with those of each
+        // Lehmer step, and with the matrices of the half-gcd algorithm on large values; the one of x is never computed.
+        static digit_buffer gcd_cofactor(digit_buffer x, digit_buffer y, digit_buffer& cofactor, bool& is_negative)
+        {
+            // The cofactors of x and y, which have opposite signs (that of x being negative if 'is_negative').
+            digit_buffer first, second{1};
+            is_negative = true;
+            digit_buffer quotient, remainder;
+            while(!y.empty())
+            {
+                if(x.size() >= subquadratic_gcd_threshold)
+                {
+                    quotient_matrix matrix;
+                    std::vector<digit_buffer> quotients;
+                    half_gcd(x, y, x.size() / 2, matrix, quotients);
+                    if(quotients.empty())
+                    {
+                        euclid_step(x, y, matrix, quotients);
+                    }
+                    // The cofactors go through the inverse of the matrix, as the remainders do.
+                    digit_buffer next = add_buffers(multiply_buffers(matrix.entries[1][1], first), multiply_buffers(matrix.entries[0][1], second));
+                    second = add_buffers(multiply_buffers(matrix.entries[1][0], first), multiply_buffers(matrix.entries[0][0], second));
+                    first = std::move(next);
+                    is_negative = is_negative xor matrix.is_odd;
+                    continue;
+                }
+                int64_t a = 1, b = 0, c = 0, d = 1;
+                if(x.size() > 2 and x.size() - y.size() <= 1)
+                {
+                    lehmer_cofactors(x, y, a, b, c, d);
+                }
+                if(b != 0)
+                {
+                    apply_cofactors(x, y, a, b, c, d);
+                    // The entries of each row have opposite signs, as do the cofactors, so only their magnitudes are added. d is
+                    // negative after an odd number of steps.
+                    const auto entry = [](const int64_t value)
+                    {
+                        return static_cast<digit>(value < 0 ? -value : value);
+                    };
+                    multiply_row(first, second, entry(a), entry(c), entry(b), entry(d));
+                    is_negative = is_negative xor (d < 0);
+                    continue;
+                }
+                divide_buffers(quotient, remainder, x, y);
+                step_cofactors(first, second, quotient);
+                is_negative = !is_negative;
+                std::swap(x, y);
+                std::swap(y, remainder);
             }
-            // For each bit in the resulting digit, check in descending order whether each one of them being set overshoots the solution.
-            digit cur = 0;
-            for(int i = 31; i >= 0; i--)
+            cofactor = std::move(first);
+            return x;
+        }
+        // The width of the windows of the exponentiation by a (non-zero) exponent, which trades the odd powers computed up front for
+        // the multiplications saved.
+        static int window_width(const digit_buffer& exponent)
+        {
+            const std::size_t bits = 32 * exponent.size() - leading_zeros(exponent.back());
+            return bits > 671 ? 6 : bits > 239 ? 5 : bits > 79 ? 4 : bits > 23 ? 3 : 1;
+        }
+        // Left-to-right sliding-window exponentiation by a (non-zero) exponent, with windows of at most 'width' bits that end on a set
+        // bit: start(i) sets the result to the i-th odd power (the base to 2i + 1), square() squares it and multiply(i) multiplies it
+        // by the i-th odd power.
+        template<typename Start, typename Square, typename Multiply>
+        static void sliding_window_power(const digit_buffer& exponent, const int width, Start start, Square square, Multiply multiply)
+        {
+            const auto is_set = [&exponent](const std::size_t bit)
+            {
+                return (exponent[bit / 32] >> (bit % 32)) & 1;
+            };
+            bool is_started = false;
+            for(std::size_t bit = 32 * exponent.size() - leading_zeros(exponent.back()); bit > 0;)
             {
-                if(!is_less_than(x, multiply_integer_by_digit(y, cur | (1 << i))))
+                if(!is_set(bit - 1))
                 {
-                    cur |= (1 << i);
+                    square();
+                    bit--;
+                    continue;
                 }
+                std::size_t low = bit > static_cast<std::size_t>(width) ? bit - width : 0;
+                while(!is_set(low))
+                {
+                    low++;
+                }
+                const std::size_t window = buffer_bits(exponent, low, static_cast<int>(bit - low));
+                if(is_started)
+                {
+                    for(std::size_t i = low; i < bit; i++)
+                    {
+                        square();
+                    }
+                    multiply(window / 2);
+                }
+                else
+                {
+                    start(window / 2);
+                    is_started = true;
+                }
+                bit = low;
             }
-            return cur;
         }
+    public:
+        class reciprocal
+        {
+        public:
+            // Precompute the reciprocal of a (non-zero) divisor.
+            static reciprocal create(const integer& divisor)
+            {
+                if(is_equal_to(divisor, zero))
+                {
+                    throw std::logic_error("Division by 0 impermissible.");
+                }
+                reciprocal y;
+                y.divisor_digits = divisor.digits;
+                y.is_negative = divisor.is_negative;
+                const digit_buffer buffer = buffer_from_digits(divisor.digits);
+                // Small divisors are divided faster with long division, so there is nothing to precompute.
+                if(buffer.size() >= reciprocal_threshold)
+                {
+                    y.shift = leading_zeros(buffer.back());
+                    y.normalized_divisor.resize(buffer.size());
+                    shift_digits_left(y.normalized_divisor.data(), buffer.data(), buffer.size(), y.shift);
+                    y.inverse = newton_reciprocal(y.normalized_divisor.data(), y.normalized_divisor.size());
+                }
+                return y;
+            }
+            // The divisor the reciprocal was computed for.
+            integer divisor() const
+            {
+                return integer::create(divisor_digits, is_negative);
+            }
+        private:
+            friend class integer;
+            // The divisor itself.
+            integer_digits divisor_digits;
+            bool is_negative = false;
+            // The divisor shifted left by 'shift' bits, so that its top bit is set.
+            digit_buffer normalized_divisor;
+            int shift = 0;
+            // floor(B^(2n) / normalized_divisor), empty if the divisor is too small to benefit from it.
+            digit_buffer inverse;
+        };
+        // Incremental parser, for numbers that arrive in pieces (from a stream, a file descriptor or any other source) and need not be held
+        // as a string. Power-of-two radices are packed into digits as the characters arrive. In other radices, every full chunk is merged
+        // with the previous ones like a binary counter: two partial results of 2^k chunks each are joined into one of 2^(k + 1) chunks, so
+        // the merges are as balanced as in create and the extra memory stays within the size of the result.
+        class parser
+        {
+        public:
+            // Start parsing a number in a radix from 2 to 36.
+            static parser create(const int radix = 10)
+            {
+                check_radix(radix);
+                parser p;
+                p.radix = radix;
+                p.bits = (radix & (radix - 1)) == 0 ? trailing_zeros(static_cast<digit>(radix)) : 0;
+                p.chunk_size = radix_chunk_size(radix);
+                return p;
+            }
+            // Take the characters of the number from a piece of it: an optional sign at the very start, then digits. Returns how many
+            // characters were taken, which stops at the first one that is not a digit, and after it, nothing more is taken.
+            std::size_t feed(const std::string_view str)
+            {
+                if(is_done or str.empty())
+                {
+                    return 0;
+                }
+                std::size_t begin = 0;
+                if(!has_started and (str[0] == '-' or str[0] == '+'))
+                {
+                    is_negative = str[0] == '-';
+                    begin = 1;
+                }
+                has_started = true;
+                std::size_t end = begin;
+                while(end < str.size() and get_digit_character_value(str[end]) < radix)
+                {
+                    end++;
+                }
+                take_digits(str.substr(begin, end - begin));
+                is_done = end < str.size();
+                return end;
+            }
+            // Read the number from a stream, skipping the whitespace before it (like operator>>) and leaving the first character after it
+            // in the stream.
+            void read(std::istream& in)
+            {
+                const std::istream::sentry sentry(in);
+                if(!sentry)
+                {
+                    return;
+                }
+                std::streambuf& buffer = *in.rdbuf();
+                using traits = std::istream::traits_type;
+                int c = buffer.sgetc();
+                if(!has_started and (c == '-' or c == '+'))
+                {
+                    const char sign = static_cast<char>(c);
+                    feed(std::string_view(&sign, 1));
+                    c = buffer.snextc();
+                }
+                char block[4096];
+                std::size_t size = 0;
+                for(; c != traits::eof() and get_digit_character_value(static_cast<char>(c)) < radix; c = buffer.snextc())
+                {
+                    block[size++] = static_cast<char>(c);
+                    if(size == sizeof(block))
+                    {
+                        feed(std::string_view(block, size));
+                        size = 0;
+                    }
+                }
+                feed(std::string_view(block, size));
+                if(c == traits::eof())
+                {
+                    in.setstate(std::ios_base::eofbit);
+                }
+            }
+#if defined(__unix__) || defined(__APPLE__)
+            // Read the number from a file descriptor until its end, where only whitespace may follow the number.
+            void read(const int fd)
+            {
+                char block[65536];
+                while(true)
+                {
+                    const ssize_t size = ::read(fd, block, sizeof(block));
+                    if(size < 0 and errno == EINTR)
+                    {
+                        continue;
+                    }
+                    if(size < 0)
+                    {
+                        throw std::runtime_error("Reading the file descriptor failed.");
+                    }
+                    if(size == 0)
+                    {
+                        return;
+                    }
+                    take(std::string_view(block, size));
+                }
+            }
+#endif
+            // Read the number from a source that returns its pieces (as anything convertible to std::string_view) until it returns an empty
+            // one, where only whitespace may follow the number.
+            template<typename Source>
+            void read_chunks(Source&& source)
+            {
+                for(std::string_view piece = source(); !piece.empty(); piece = source())
+                {
+                    take(piece);
+                }
+            }
+            // The number that was read, after which the parser starts over.
+            integer finish()
+            {
+                if(!has_digits)
+                {
+                    throw std::logic_error("No digits to parse.");
+                }
+                digit_buffer result = bits != 0 ? join_bits() : join_chunks();
+                trim(result);
+                const integer x = integer::create(digits_from_buffer(result), is_negative and !result.empty());
+                *this = create(radix);
+                return x;
+            }
+        private:
+            friend class integer;
+            int radix = 10;
+            // log2 of a power-of-two radix, else 0.
+            int bits = 0;
+            std::size_t chunk_size = 0;
+            bool is_negative = false;
+            // Whether any character was taken (after which a sign is no longer expected).
+            bool has_started = false;
+            bool has_digits = false;
+            // Whether a character after the number was seen.
+            bool is_done = false;
+            // The chunk (or the bits) being read.
+            superdigit current = 0;
+            std::size_t current_size = 0;
+            // Power-of-two radices: the digits read so far, most significant first.
+            digit_buffer packed_digits;
+            // Other radices: the partial results of the full chunks, each of 2^level of them, the most significant first.
+            std::vector<std::pair<digit_buffer, std::size_t>> partials;
+            // Feed a piece, where only whitespace may follow the number.
+            void take(const std::string_view str)
+            {
+                const std::size_t taken = feed(str);
+                for(std::size_t i = taken; i < str.size(); i++)
+                {
+                    if(!std::isspace(static_cast<unsigned char>(str[i])))
+                    {
+                        throw std::logic_error("Invalid digit.");
+                    }
+                }
+            }
+            // Take a run of valid digits.
+            void take_digits(std::string_view str)
+            {
+                has_digits = has_digits or !str.empty();
+                if(bits != 0)
+                {
+                    for(const char c : str)
+                    {
+                        current = (current << bits) | get_digit_character_value(c);
+                        current_size += bits;
+                        if(current_size >= 32)
+                        {
+                            current_size -= 32;
+                            packed_digits.push_back(static_cast<digit>(current >> current_size));
+                            current &= (superdigit(1) << current_size) - 1;
+                        }
+                    }
+                    return;
+                }
+                while(!str.empty())
+                {
+                    // Whole chunks are converted at once.
+                    if(current_size == 0 and str.size() >= chunk_size)
+                    {
+                        push_chunk(radix_chunk_value(str.data(), chunk_size, radix));
+                        str.remove_prefix(chunk_size);
+                        continue;
+                    }
+                    current = current * radix + get_digit_character_value(str[0]);
+                    str.remove_prefix(1);
+                    if(++current_size == chunk_size)
+                    {
+                        push_chunk(current);
+                        current = 0;
+                        current_size = 0;
+                    }
+                }
+            }
+            // Add a full chunk, merging the partial results of equal size.
+            void push_chunk(const superdigit chunk)
+            {
+                digit_buffer value = {static_cast<digit>(chunk), static_cast<digit>(chunk >> 32)};
+                trim(value);
+                partials.emplace_back(std::move(value), 0);
+                while(partials.size() >= 2 and partials[partials.size() - 2].second == partials.back().second)
+                {
+                    const std::size_t level = partials.back().second;
+                    digit_buffer low = std::move(partials.back().first);
+                    partials.pop_back();
+                    partials.back().first = join_radix_halves(partials.back().first, low, radix_power(radix, level));
+                    partials.back().second = level + 1;
+                }
+            }
+            // The digits of a power-of-two radix: the packed digits in reverse order, followed by the bits of the last partial digit.
+            digit_buffer join_bits() const
+            {
+                digit_buffer result(packed_digits.rbegin(), packed_digits.rend());
+                result.push_back(0);
+                result.back() = shift_digits_left(result.data(), result.data(), result.size() - 1, static_cast<int>(current_size));
+                result[0] |= static_cast<digit>(current);
+                return result;
+            }
+            // The value in other radices: the partial results from the most significant, each multiplied in by the power of the chunk base
+            // for its size, and then the digits of the last partial chunk.
+            digit_buffer join_chunks() const
+            {
+                digit_buffer result;
+                for(const auto& partial : partials)
+                {
+                    result = join_radix_halves(result, partial.first, radix_power(radix, partial.second));
+                }
+                superdigit scale = 1;
+                for(std::size_t i = 0; i < current_size; i++)
+                {
+                    scale *= radix;
+                }
+                result.resize(result.size() + 2);
+                const superdigit carry = multiply_add_word(result.data(), result.size() - 2, scale, current);
+                result[result.size() - 2] = static_cast<digit>(carry);
+                result[result.size() - 1] = static_cast<digit>(carry >> 32);
+                return result;
+            }
+        };
+        // Barrett reduction modulo a fixed modulus: the scaled reciprocal is computed once, after which reductions only multiply and subtract.
+        // All operations are const and keep no scratch state, so one context can be shared read-only between threads.
+        class barrett_context
+        {
+        public:
+            // Build the context for a non-zero modulus (its sign is ignored).
+            static barrett_context create(const integer& modulus)
+            {
+                if(is_equal_to(modulus, zero))
+                {
+                    throw std::logic_error("Division by 0 impermissible.");
+                }
+                barrett_context context;
+                context.modulus_buffer = buffer_from_digits(modulus.digits);
+                // mu = floor(B^(2k) / m), where k is the number of digits of m.
+                const std::size_t k = context.modulus_buffer.size();
+                digit_buffer power(2 * k + 1, 0), remainder;
+                power.back() = 1;
+                divide_buffers(context.mu, remainder, power, context.modulus_buffer);
+                return context;
+            }
+            // The (positive) modulus.
+            integer modulus() const
+            {
+                return integer::create(digits_from_buffer(modulus_buffer), false);
+            }
+            // x mod m, in [0, m).
+            integer reduce(const integer& x) const
+            {
+                digit_buffer r = reduce_buffer(buffer_from_digits(x.digits));
+                if(x.is_negative and !r.empty())
+                {
+                    r = subtract_buffers(modulus_buffer, r);
+                }
+                return integer::create(digits_from_buffer(r), false);
+            }
+            // x * y mod m, in [0, m).
+            integer mulmod(const integer& x, const integer& y) const
+            {
+                const integer product = integer::create(digits_from_buffer(multiply_buffers(buffer_from_digits(reduce(x).digits), buffer_from_digits(reduce(y).digits))), false);
+                return reduce(product);
+            }
+            // base^exponent mod m, in [0, m), for a non-negative exponent, by sliding windows.
+            integer powmod(const integer& base, const integer& exponent) const
+            {
+                if(exponent.is_negative and !exponent.digits.empty())
+                {
+                    throw std::logic_error("Negative exponent impermissible.");
+                }
+                const digit_buffer e = buffer_from_digits(exponent.digits);
+                if(e.empty())
+                {
+                    return reduce(one);
+                }
+                const std::size_t k = modulus_buffer.size();
+                const int width = window_width(e);
+                const std::size_t count = std::size_t(1) << (width - 1);
+                // The odd powers of the base in one table, k digits each (as is the result), so that every product is k by k digits.
+                digit_buffer table(count * k, 0), result(k, 0), product(2 * k), scratch(4 * k + 4);
+                const digit_buffer b = buffer_from_digits(reduce(base).digits);
+                std::copy(b.begin(), b.end(), table.begin());
+                if(count > 1)
+                {
+                    digit_buffer square_of_base(k);
+                    square_buffers(product.data(), table.data(), k);
+                    reduce_product(square_of_base.data(), product.data(), scratch.data());
+                    for(std::size_t i = 1; i < count; i++)
+                    {
+                        multiply_buffers(product.data(), table.data() + (i - 1) * k, k, square_of_base.data(), k);
+                        reduce_product(table.data() + i * k, product.data(), scratch.data());
+                    }
+                }
+                sliding_window_power(e, width, [&](const std::size_t i)
+                {
+                    std::copy(table.begin() + i * k, table.begin() + (i + 1) * k, result.begin());
+                }, [&]()
+                {
+                    square_buffers(product.data(), result.data(), k);
+                    reduce_product(result.data(), product.data(), scratch.data());
+                }, [&](const std::size_t i)
+                {
+                    multiply_buffers(product.data(), result.data(), k, table.data() + i * k, k);
+                    reduce_product(result.data(), product.data(), scratch.data());
+                });
+                trim(result);
+                return integer::create(digits_from_buffer(result), false);
+            }
+        private:
+            friend class integer;
+            // The modulus m (k digits).
+            digit_buffer modulus_buffer;
+            // floor(B^(2k) / m).
+            digit_buffer mu;
+            // x mod m for a buffer of any size, reduced k digits at a time from the top. Every step reduces a 2k-digit window (the
+            // remainder so far above the next digits of x) with the same scratch, so a reduction allocates only once.
+            digit_buffer reduce_buffer(const digit_buffer& x) const
+            {
+                const std::size_t k = modulus_buffer.size();
+                digit_buffer window(2 * k, 0), r(k), scratch(4 * k + 4);
+                std::size_t position = x.size() - std::min(x.size(), 2 * k);
+                std::copy(x.begin() + position, x.end(), window.begin());
+                reduce_product(r.data(), window.data(), scratch.data());
+                while(position > 0)
+                {
+                    const std::size_t size = std::min(k, position);
+                    position -= size;
+                    const auto next = std::copy(x.begin() + position, x.begin() + position + size, window.begin());
+                    std::fill(std::copy(r.begin(), r.end(), next), window.end(), 0);
+                    reduce_product(r.data(), window.data(), scratch.data());
+                }
+                trim(r);
+                return r;
+            }
+            // destination = x mod m, as k digits (zero-padded), for a 2k-digit x (Barrett's algorithm on fixed sizes). The products go
+            // into the 4k + 4 digits of scratch t, so nothing is allocated below the Karatsuba threshold.
+            void reduce_product(digit* destination, const digit* x, digit* t) const
+            {
+                const std::size_t k = modulus_buffer.size();
+                // q = floor(floor(x / B^(k - 1)) * mu / B^(k + 1)), which is at most 2 below floor(x / m). Only q mod B^(k + 1) is needed.
+                digit* const q = t;
+                multiply_buffers(q, x + k - 1, k + 1, mu.data(), mu.size());
+                digit* const product = t + 2 * k + 3;
+                multiply_buffers(product, q + k + 1, k + 1, modulus_buffer.data(), k);
+                // r = x - q m is below 3m, so its low k + 1 digits are enough.
+                digit* const r = t;
+                std::copy(x, x + k + 1, r);
+                subtract_digits(r, k + 1, product, k + 1);
+                while(r[k] != 0 or compare_buffers(r, k, modulus_buffer.data(), k) >= 0)
+                {
+                    subtract_digits(r, k + 1, modulus_buffer.data(), k);
+                }
+                std::copy(r, r + k, destination);
+            }
+        };
+        // Montgomery arithmetic modulo a fixed odd modulus m, on 64-bit words: with R = 2^(64n) for an n-word modulus, values are kept
+        // as x * R mod m, so that products are reduced with multiplications and shifts (REDC) instead of division. The common sizes of
+        // 256, 512, 1024, 2048 and 4096 bits get kernels with a compile-time word count, which the compiler fully unrolls.
+        // All operations are const, so one context can be shared read-only between threads.
+        class montgomery_context
+        {
+        public:
+            // Build the context for an odd modulus (its sign is ignored).
+            static montgomery_context create(const integer& modulus)
+            {
+                const digit_buffer m = buffer_from_digits(modulus.digits);
+                if(m.empty() or m[0] % 2 == 0)
+                {
+                    throw std::logic_error("Montgomery arithmetic needs an odd modulus.");
+                }
+                montgomery_context context;
+                context.modulus_buffer = m;
+                context.modulus_words = words_from_buffer(m, (m.size() + 1) / 2);
+                // -m^-1 mod 2^64, by Newton's iteration (m * m = 1 mod 8 already gives 3 correct bits, each step doubles them).
+                superdigit inverse = context.modulus_words[0];
+                for(int i = 0; i < 5; i++)
+                {
+                    inverse *= 2 - context.modulus_words[0] * inverse;
+                }
+                context.inverse = 0 - inverse;
+                // R^2 mod m, for conversions into Montgomery form.
+                digit_buffer power(4 * context.modulus_words.size() + 1, 0), quotient, remainder;
+                power.back() = 1;
+                divide_buffers(quotient, remainder, power, m);
+                context.r_squared = words_from_buffer(remainder, context.modulus_words.size());
+                return context;
+            }
+            // The (positive) modulus.
+            integer modulus() const
+            {
+                return integer::create(digits_from_buffer(modulus_buffer), false);
+            }
+            // x * R mod m (into Montgomery form).
+            integer to_montgomery(const integer& x) const
+            {
+                return integer_from_words(multiply(words_from_integer(x), r_squared));
+            }
+            // x * R^-1 mod m (out of Montgomery form).
+            integer from_montgomery(const integer& x) const
+            {
+                return redc(x);
+            }
+            // Montgomery product x * y * R^-1 mod m.
+            integer montmul(const integer& x, const integer& y) const
+            {
+                return integer_from_words(multiply(words_from_integer(x), words_from_integer(y)));
+            }
+            // Montgomery square x^2 * R^-1 mod m.
+            integer montsqr(const integer& x) const
+            {
+                return integer_from_words(square(words_from_integer(x)));
+            }
+            // base^exponent mod m, in [0, m), for a non-negative exponent, by sliding windows on Montgomery forms.
+            integer powmod(const integer& base, const integer& exponent) const
+            {
+                if(exponent.is_negative and !exponent.digits.empty())
+                {
+                    throw std::logic_error("Negative exponent impermissible.");
+                }
+                const digit_buffer e = buffer_from_digits(exponent.digits);
+                if(e.empty())
+                {
+                    return integer_from_words(words_from_integer(one));
+                }
+                const std::size_t n = modulus_words.size();
+                const int width = window_width(e);
+                const std::size_t count = std::size_t(1) << (width - 1);
+                // The odd powers of the base in one table, n words each, and scratch enough for the kernels.
+                word_buffer table(count * n), result(n), scratch(2 * n + 2);
+                multiply(table.data(), words_from_integer(base).data(), r_squared.data(), scratch.data());
+                if(count > 1)
+                {
+                    word_buffer square_of_base(n);
+                    square(square_of_base.data(), table.data(), scratch.data());
+                    for(std::size_t i = 1; i < count; i++)
+                    {
+                        multiply(table.data() + i * n, table.data() + (i - 1) * n, square_of_base.data(), scratch.data());
+                    }
+                }
+                sliding_window_power(e, width, [&](const std::size_t i)
+                {
+                    std::copy(table.begin() + i * n, table.begin() + (i + 1) * n, result.begin());
+                }, [&]()
+                {
+                    square(result.data(), result.data(), scratch.data());
+                }, [&](const std::size_t i)
+                {
+                    multiply(result.data(), result.data(), table.data() + i * n, scratch.data());
+                });
+                // Out of Montgomery form.
+                std::fill(std::copy(result.begin(), result.end(), scratch.begin()), scratch.begin() + 2 * n, 0);
+                reduce(result.data(), scratch.data());
+                return integer_from_words(result);
+            }
+            // Montgomery reduction t * R^-1 mod m, for 0 <= t < m * R.
+            integer redc(const integer& t) const
+            {
+                const std::size_t n = modulus_words.size();
+                const digit_buffer buffer = buffer_from_digits(t.digits);
+                // t = t1 * R + t0 with t0 < R, so t < m * R exactly when t1 < m.
+                const digit_buffer high = high_digits(buffer, 2 * n);
+                const bool is_negative = t.is_negative and !t.digits.empty();
+                if(is_negative or compare_buffers(high.data(), high.size(), modulus_buffer.data(), modulus_buffer.size()) >= 0)
+                {
+                    throw std::logic_error("Montgomery reduction needs 0 <= t < m * R.");
+                }
+                word_buffer wide = words_from_buffer(buffer, 2 * n), result(n);
+                reduce(result.data(), wide.data());
+                return integer_from_words(result);
+            }
+        private:
+            friend class integer;
+            using word_buffer = std::vector<superdigit>;
+            // The modulus, as digits and as n words.
+            digit_buffer modulus_buffer;
+            word_buffer modulus_words;
+            // -m^-1 mod 2^64.
+            superdigit inverse = 0;
+            // R^2 mod m.
+            word_buffer r_squared;
+            // Pack digits into 'size' words (zero-padded).
+            static word_buffer words_from_buffer(const digit_buffer& x, const std::size_t size)
+            {
+                word_buffer words(size, 0);
+                for(std::size_t i = 0; i < x.size(); i++)
+                {
+                    words[i / 2] |= static_cast<superdigit>(x[i]) << (32 * (i % 2));
+                }
+                return words;
+            }
+            // The words of x mod m (x is reduced first when it is negative or not less than m).
+            word_buffer words_from_integer(const integer& x) const
+            {
+                digit_buffer buffer = buffer_from_digits(x.digits);
+                if(x.is_negative or compare_buffers(buffer.data(), buffer.size(), modulus_buffer.data(), modulus_buffer.size()) >= 0)
+                {
+                    digit_buffer quotient, remainder;
+                    divide_buffers(quotient, remainder, buffer, modulus_buffer);
+                    buffer = x.is_negative and !remainder.empty() ? subtract_buffers(modulus_buffer, remainder) : remainder;
+                }
+                return words_from_buffer(buffer, modulus_words.size());
+            }
+            static integer integer_from_words(const word_buffer& words)
+            {
+                digit_buffer buffer(2 * words.size());
+                for(std::size_t i = 0; i < words.size(); i++)
+                {
+                    buffer[2 * i] = static_cast<digit>(words[i]);
+                    buffer[2 * i + 1] = static_cast<digit>(words[i] >> 32);
+                }
+                trim(buffer);
+                return integer::create(digits_from_buffer(buffer), false);
+            }
+            word_buffer multiply(const word_buffer& x, const word_buffer& y) const
+            {
+                word_buffer result(modulus_words.size());
+                multiply(result.data(), x.data(), y.data());
+                return result;
+            }
+            word_buffer square(const word_buffer& x) const
+            {
+                word_buffer result(modulus_words.size());
+                square(result.data(), x.data());
+                return result;
+            }
+            // result = x * y * R^-1 mod m, for n-word x, y in [0, m). The result may alias the operands. Sizes without a fixed-size
+            // kernel use the n + 2 words of scratch t if given, and allocate them otherwise.
+            void multiply(superdigit* result, const superdigit* x, const superdigit* y, superdigit* t = nullptr) const
+            {
+                superdigit scratch[fixed_size_limit + 2];
+                switch(modulus_words.size())
+                {
+                case 4:
+                    return montgomery_multiply(result, x, y, modulus_words.data(), std::integral_constant<std::size_t, 4>(), inverse, scratch);
+                case 8:
+                    return montgomery_multiply(result, x, y, modulus_words.data(), std::integral_constant<std::size_t, 8>(), inverse, scratch);
+                case 16:
+                    return montgomery_multiply(result, x, y, modulus_words.data(), std::integral_constant<std::size_t, 16>(), inverse, scratch);
+                case 32:
+                    return montgomery_multiply(result, x, y, modulus_words.data(), std::integral_constant<std::size_t, 32>(), inverse, scratch);
+                case 64:
+                    return montgomery_multiply(result, x, y, modulus_words.data(), std::integral_constant<std::size_t, 64>(), inverse, scratch);
+                default:
+                {
+                    word_buffer buffer(t == nullptr ? modulus_words.size() + 2 : 0);
+                    return montgomery_multiply(result, x, y, modulus_words.data(), modulus_words.size(), inverse, t == nullptr ? buffer.data() : t);
+                }
+                }
+            }
+            // result = x^2 * R^-1 mod m, for n-word x in [0, m). The result may alias the operand. Sizes without a fixed-size kernel
+            // use the 2n words of scratch t if given, and allocate them otherwise.
+            void square(superdigit* result, const superdigit* x, superdigit* t = nullptr) const
+            {
+                superdigit scratch[2 * fixed_size_limit];
+                switch(modulus_words.size())
+                {
+                case 4:
+                    return montgomery_square(result, x, modulus_words.data(), std::integral_constant<std::size_t, 4>(), inverse, scratch);
+                case 8:
+                    return montgomery_square(result, x, modulus_words.data(), std::integral_constant<std::size_t, 8>(), inverse, scratch);
+                case 16:
+                    return montgomery_square(result, x, modulus_words.data(), std::integral_constant<std::size_t, 16>(), inverse, scratch);
+                case 32:
+                    return montgomery_square(result, x, modulus_words.data(), std::integral_constant<std::size_t, 32>(), inverse, scratch);
+                case 64:
+                    return montgomery_square(result, x, modulus_words.data(), std::integral_constant<std::size_t, 64>(), inverse, scratch);
+                default:
+                {
+                    word_buffer buffer(t == nullptr ? 2 * modulus_words.size() : 0);
+                    return montgomery_square(result, x, modulus_words.data(), modulus_words.size(), inverse, t == nullptr ? buffer.data() : t);
+                }
+                }
+            }
+            // result = t * R^-1 mod m, for a 2n-word t < m * R, which is used as scratch.
+            void reduce(superdigit* result, superdigit* t) const
+            {
+                montgomery_reduce(result, t, modulus_words.data(), modulus_words.size(), inverse);
+            }
+            // The largest word count with a fixed-size kernel.
+            static constexpr std::size_t fixed_size_limit = 64;
+        };
     };
 }
 
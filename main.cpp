@@ -1,7 +1,9 @@
 #include "integer.h"
 #include <iostream>
 #include <unordered_map>
-#include <regex>
+#include <limits>
+#include <stdexcept>
+#include <string>
 
 using int_titan::integer;
 
@@ -9,46 +11,50 @@ void free_calculator()
 {
     while(true)
     {
-        std::cout << "Radix = 16" << std::endl;
-        int radix = 16; // Currently, only hex is supported.
-        std::cout << "Enter the expression (end with '='):" << std::endl;
-        std::string expression;
-        std::cin.ignore();
-        std::getline(std::cin, expression, '=');
-        auto split = [](const std::string& str, const std::string& regex) -> std::vector<std::string>
+        std::cout << "Enter the radix (2-36):" << std::endl;
+        int radix = 0;
+        if(!(std::cin >> radix))
         {
-            std::regex r(regex);
-            return {std::sregex_token_iterator(str.begin(), str.end(), r, -1), std::sregex_token_iterator()};
-        };
-        std::vector<std::string> terms = split(expression, R"([+\-\n])");
-        std::vector<char> operations;
-        if(expression[0] != '+' and expression[0] != '-')
+            return;
+        }
+        if(radix < 2 or radix > 36)
         {
-            operations.emplace_back('+');
+            std::cout << "No such radix." << std::endl;
+            continue;
         }
-        for(char c : expression)
+        std::cout << "Enter the expression (end with '='):" << std::endl;
+        // The terms are parsed straight from the input, one at a time.
+        integer result = integer::zero;
+        char operation = '+';
+        try
         {
-            if(c == '+' or c == '-')
+            while(operation != '=')
             {
-                operations.emplace_back(c);
+                integer::parser term = integer::parser::create(radix);
+                term.read(std::cin);
+                result = operation == '+' ? integer::add(result, term.finish()) : integer::subtract(result, term.finish());
+                if(!(std::cin >> operation))
+                {
+                    return;
+                }
+                if(operation != '+' and operation != '-' and operation != '=')
+                {
+                    throw std::logic_error(std::string("Invalid operator '") + operation + "'.");
+                }
             }
         }
-        auto compute = [](const std::vector<std::string>& terms, const std::vector<char>& operations, const int radix) -> integer
+        catch(const std::logic_error& error)
         {
-            assert(terms.size() == operations.size());
-            integer sum = integer::create("0", radix);
-            for(int i = 0; i < terms.size(); i++)
+            // An invalid or missing term, or an invalid operator: the rest of the line is dropped and the calculator starts over.
+            std::cout << "Invalid expression: " << error.what() << std::endl;
+            if(std::cin.eof())
             {
-                integer num = integer::create(terms[i], radix == 16);
-                if(operations[i] == '-')
-                {
-                    num = integer::negate(num);
-                }
-                sum = integer::add(sum, num);
+                return;
             }
-            return sum;
-        };
-        integer result = compute(terms, operations, radix);
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            continue;
+        }
         std::cout << integer::to_string(result, radix, true) << std::endl;
     }
 }
@@ -59,8 +65,11 @@ int main()
     std::cout << "1. Free calculator." << std::endl;
     while(true)
     {
-        int selected;
-        std::cin >> selected;
+        int selected = 0;
+        if(!(std::cin >> selected))
+        {
+            return 0;
+        }
         std::unordered_map<int, decltype(&free_calculator)> options = {{ 1, &free_calculator }};
         if (options.find(selected) != options.end())
         {
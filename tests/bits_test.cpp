@@ -0,0 +1,244 @@
+#include "integer.h"
+#include "tests/test.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using int_titan::integer;
+using int_titan::test::power_of_two;
+using int_titan::test::random_integer;
+
+// floor(x / y) for a positive y.
+integer floor_divide(const integer& x, const integer& y)
+{
+    const auto [quotient, remainder] = integer::divide(x, y);
+    return remainder < 0 ? quotient - 1 : quotient;
+}
+
+// Values spanning none, one and several digits, with runs of zero and one bits, and their negatives.
+std::vector<integer> sample_values()
+{
+    std::vector<integer> values = {0, 1, 5, 0xFFFFFFFFu, 0x100000000u, integer::create("123456789ABCDEF0FEDCBA9876543210"),
+                                   power_of_two(96), power_of_two(96) - 1, power_of_two(200) + power_of_two(64) + 3,
+                                   integer::create("F0000000000000000000000000FFFF00000000000000000000000001")};
+    for(std::size_t i = 1, count = values.size(); i < count; i++)
+    {
+        values.push_back(-values[i]);
+    }
+    return values;
+}
+
+void check_shifts()
+{
+    for(const integer& x : sample_values())
+    {
+        // Amounts inside a digit, of whole digits (which shift structurally) and past the length of x.
+        for(const std::size_t bits : {0, 1, 5, 31, 32, 33, 63, 64, 65, 96, 127, 128, 500, 1024})
+        {
+            const integer power = power_of_two(bits);
+            CHECK(integer::shift_bits_left(x, bits) == x * power);
+            CHECK((x << bits) == x * power);
+            // Right shifts round towards minus infinity, as on two's complement.
+            CHECK(integer::shift_bits_right(x, bits) == floor_divide(x, power));
+            CHECK((x >> bits) == floor_divide(x, power));
+            CHECK(((x << bits) >> bits) == x);
+            integer y = x;
+            y <<= bits;
+            y >>= bits;
+            CHECK(y == x);
+            if(bits % 32 == 0)
+            {
+                // Whole digits, added or dropped from the magnitude.
+                const int digits = static_cast<int>(bits / 32);
+                CHECK(integer::shift_left(x, digits) == x * power);
+                CHECK(integer::shift_right(x, digits) == x / power);
+            }
+        }
+    }
+    CHECK((integer(-1) >> 1000) == -1);
+    CHECK((-power_of_two(64) >> 64) == -1);
+    CHECK((-(power_of_two(64) + 1) >> 64) == -2);
+}
+
+// Whole-digit shifts by far more digits than the value has, which only concatenate shared blocks of zeroes (and so run in time
+// logarithmic in the amount, rather than writing out hundreds of megabytes of them).
+void check_long_shifts()
+{
+    integer::superdigit state = 1;
+    const integer x = random_integer(5000, state);
+    const std::size_t bits = integer::bit_length(x);
+    for(const int digits : {1 << 20, (1 << 26) + 12345})
+    {
+        const std::size_t shift = 32 * static_cast<std::size_t>(digits);
+        const integer shifted = integer::shift_left(x, digits);
+        CHECK(integer::bit_length(shifted) == bits + shift);
+        CHECK(integer::test_bit(shifted, bits + shift - 1));
+        CHECK(!integer::test_bit(shifted, shift - 1));
+        CHECK(integer::test_bit(shifted, shift) == integer::test_bit(x, 0));
+        CHECK(integer::shift_right(shifted, digits) == x);
+        CHECK(integer::shift_left(-x, digits) == -shifted);
+        // Bit shifts take the whole digits structurally too, and shift only the digits of x.
+        CHECK(integer::shift_bits_left(x, shift + 7) == integer::shift_left(x << 7, digits));
+        CHECK(integer::shift_bits_right(integer::shift_bits_left(x, shift + 7), shift + 7) == x);
+    }
+    // Repeated shifts of the same value share its digits and the blocks of zeroes.
+    integer restored = 0;
+    for(int i = 0; i < 200; i++)
+    {
+        restored = integer::shift_right(integer::shift_left(x, (1 << 22) + i), (1 << 22) + i);
+    }
+    CHECK(restored == x);
+}
+
+// The lowest 32 bits of x in two's complement.
+std::uint32_t low_digit(const integer& x)
+{
+    return integer::to<std::uint32_t>(x - ((x >> 32) << 32));
+}
+
+// A bitwise operation on infinite two's complement, 32 bits at a time: the digits come from floor shifts (which give those of the two's
+// complement of negative values), and all the bits above them are the operation on the signs.
+template<typename Operation>
+integer bitwise_by_digits(const integer& x, const integer& y, Operation operation)
+{
+    const std::size_t count = std::max(integer::bit_length(x), integer::bit_length(y)) / 32 + 1;
+    integer result = 0;
+    for(std::size_t i = count; i-- > 0;)
+    {
+        result = (result << 32) + operation(low_digit(x >> (32 * i)), low_digit(y >> (32 * i)));
+    }
+    const std::uint32_t sign = operation(x < 0 ? ~0u : 0u, y < 0 ? ~0u : 0u);
+    return sign != 0 ? result - power_of_two(32 * count) : result;
+}
+
+void check_bitwise()
+{
+    const std::vector<integer> values = sample_values();
+    for(const integer& x : values)
+    {
+        for(const integer& y : values)
+        {
+            CHECK((x & y) == bitwise_by_digits(x, y, [](std::uint32_t a, std::uint32_t b) { return a & b; }));
+            CHECK((x | y) == bitwise_by_digits(x, y, [](std::uint32_t a, std::uint32_t b) { return a | b; }));
+            CHECK((x ^ y) == bitwise_by_digits(x, y, [](std::uint32_t a, std::uint32_t b) { return a ^ b; }));
+            CHECK(integer::and_not(x, y) == bitwise_by_digits(x, y, [](std::uint32_t a, std::uint32_t b) { return a & ~b; }));
+            CHECK((x & y) + (x | y) == x + y);
+            integer z = x;
+            z &= y;
+            z |= x;
+            z ^= y;
+            CHECK(z == (x ^ y));
+        }
+        CHECK(~x == -x - 1);
+        CHECK(~~x == x);
+        CHECK((x & ~x) == 0);
+        CHECK((x | ~x) == -1);
+        CHECK((x ^ -1) == ~x);
+    }
+    // Against native two's complement.
+    const std::int64_t natives[] = {0, 1, -1, 7, -8, 0x7FFFFFFF, -0x80000000LL, 0x100000000LL, -0x100000001LL, INT64_MAX, INT64_MIN};
+    for(const std::int64_t a : natives)
+    {
+        for(const std::int64_t b : natives)
+        {
+            CHECK((integer(a) & integer(b)) == (a & b));
+            CHECK((integer(a) | integer(b)) == (a | b));
+            CHECK((integer(a) ^ integer(b)) == (a ^ b));
+        }
+        CHECK(~integer(a) == ~a);
+    }
+}
+
+// The lowest 'width' bits of x in two's complement, lowest bit first, from its binary string (so independently of the bit queries).
+std::string bits_of(const integer& x, const std::size_t width)
+{
+    std::string bits = integer::to_string(x < 0 ? power_of_two(width) + x : x, 2);
+    bits = x == 0 ? "" : bits;
+    std::reverse(bits.begin(), bits.end());
+    bits.resize(width, '0');
+    return bits;
+}
+
+// The value of a two's complement bit string, lowest bit first, whose top bit is the sign.
+integer value_of(std::string bits)
+{
+    const bool is_negative = bits.back() == '1';
+    const std::size_t width = bits.size();
+    std::reverse(bits.begin(), bits.end());
+    const integer value = integer::create(bits, 2);
+    return is_negative ? value - power_of_two(width) : value;
+}
+
+// Every bit query and update against the naive bit-string model, for indices below, at and above the lowest set bit and the length.
+void check_bit_queries()
+{
+    std::vector<integer> values = sample_values();
+    for(const std::size_t n : {0, 1, 31, 32, 33, 63, 64, 95, 96, 200})
+    {
+        values.push_back(power_of_two(n));
+        values.push_back(-power_of_two(n));
+        values.push_back(power_of_two(n) * 3 - 1);
+        values.push_back(1 - power_of_two(n) * 3);
+    }
+    for(const integer& x : values)
+    {
+        const std::size_t length = integer::bit_length(x);
+        const std::string magnitude = bits_of(integer::absolute_value(x), length);
+        CHECK(length == (x == 0 ? 0 : integer::to_string(integer::absolute_value(x), 2).size()));
+        CHECK(integer::popcount(x) == static_cast<std::size_t>(std::count(magnitude.begin(), magnitude.end(), '1')));
+        CHECK(integer::is_power_of_two(x) == (x > 0 and integer::popcount(x) == 1));
+        std::vector<std::size_t> indices = {0, 1, 31, 32, 33, 63, 64, 65, 500};
+        if(x != 0)
+        {
+            const std::size_t lowest = magnitude.find('1');
+            CHECK(integer::count_trailing_zeros(x) == lowest);
+            indices.insert(indices.end(), {lowest, lowest + 1, lowest + 2});
+            indices.insert(indices.end(), {length - 1, length, length + 1, length + 40});
+        }
+        else
+        {
+            CHECK_THROWS(integer::count_trailing_zeros(x), std::logic_error);
+        }
+        for(const std::size_t index : indices)
+        {
+            // Wide enough for the index and the sign, so that every bit above the model is the sign.
+            const std::size_t width = std::max(length, index) + 2;
+            const std::string bits = bits_of(x, width);
+            CHECK(integer::test_bit(x, index) == (bits[index] == '1'));
+            std::string set = bits, cleared = bits, flipped = bits;
+            set[index] = '1';
+            cleared[index] = '0';
+            flipped[index] = bits[index] == '1' ? '0' : '1';
+            CHECK(integer::set_bit(x, index) == value_of(set));
+            CHECK(integer::clear_bit(x, index) == value_of(cleared));
+            CHECK(integer::flip_bit(x, index) == value_of(flipped));
+            CHECK(integer::flip_bit(integer::flip_bit(x, index), index) == x);
+            const std::size_t next = bits.find('1', index);
+            CHECK(integer::find_next_set_bit(x, index) == (next != std::string::npos ? next : x < 0 ? width : integer::npos));
+        }
+        // Far above the length, a negative value only has set bits, and a non-negative one none.
+        CHECK(integer::test_bit(x, length + 10000) == (x < 0));
+        CHECK(integer::find_next_set_bit(x, length + 10000) == (x < 0 ? length + 10000 : integer::npos));
+    }
+    // Updates of negative values at and above their lowest set bit, and of 0 and a single bit.
+    CHECK(integer::clear_bit(-1, 0) == -2);
+    CHECK(integer::clear_bit(-power_of_two(64), 64) == -power_of_two(65));
+    CHECK(integer::set_bit(-power_of_two(65), 64) == -power_of_two(64));
+    CHECK(integer::set_bit(0, 100) == power_of_two(100));
+    CHECK(integer::clear_bit(power_of_two(100), 100) == 0);
+    CHECK(integer::flip_bit(-1, 0) == -2);
+    CHECK(integer::flip_bit(-2, 0) == -1);
+    CHECK(integer::set_bit(-2, 0) == -1);
+    CHECK(integer::find_next_set_bit(0, 0) == integer::npos);
+    CHECK(integer::find_next_set_bit(-1, 12345) == 12345);
+}
+
+int main()
+{
+    check_shifts();
+    check_long_shifts();
+    check_bitwise();
+    check_bit_queries();
+    return int_titan::test::result();
+}
@@ -0,0 +1,115 @@
+#include "integer.h"
+#include "tests/test.h"
+#include <algorithm>
+#include <charconv>
+#include <string>
+#include <vector>
+
+using int_titan::integer;
+using int_titan::test::random_integer;
+
+// to_chars into a buffer of 'size' characters: the lowercase string when it fits (with nothing written past the buffer), and otherwise
+// value_too_large with nothing written at all.
+void check_to_chars(const integer& x, const int radix, const std::size_t size)
+{
+    const std::string expected = integer::to_string(x, radix, false);
+    std::vector<char> buffer(size + 1, '#');
+    char* const last = buffer.data() + size;
+    const std::to_chars_result written = integer::to_chars(buffer.data(), last, x, radix);
+    if(expected.size() <= size)
+    {
+        CHECK(written.ec == std::errc() and written.ptr == buffer.data() + expected.size());
+        CHECK(std::string(buffer.data(), expected.size()) == expected);
+        CHECK(buffer.back() == '#');
+    }
+    else
+    {
+        CHECK(written.ec == std::errc::value_too_large and written.ptr == last);
+        CHECK(std::all_of(buffer.begin(), buffer.end(), [](const char c) { return c == '#'; }));
+    }
+}
+
+// max_chars bounds the length of x (and is exact for the radices that are powers of two), to_chars fits in a buffer of max_chars
+// characters and in one of the exact length but not shorter, and from_chars reads back what it wrote.
+void check_chars(const integer& x, const int radix)
+{
+    const std::string expected = integer::to_string(x, radix, false);
+    const std::size_t bound = integer::max_chars(x, radix);
+    CHECK(expected.size() <= bound);
+    if((radix & (radix - 1)) == 0)
+    {
+        CHECK(expected.size() == bound);
+    }
+    check_to_chars(x, radix, bound);
+    check_to_chars(x, radix, bound - 1);
+    check_to_chars(x, radix, expected.size());
+    check_to_chars(x, radix, expected.size() - 1);
+    integer y = 77;
+    const std::from_chars_result read = integer::from_chars(expected.data(), expected.data() + expected.size(), y, radix);
+    CHECK(read.ec == std::errc() and read.ptr == expected.data() + expected.size());
+    CHECK(y == x);
+}
+
+void check_every_radix()
+{
+    integer::superdigit state = 1;
+    for(int radix = 2; radix <= 36; radix++)
+    {
+        // Values of up to two digits are written on the stack, longer ones straight into the buffer when it holds max_chars.
+        std::vector<integer> values = {0, 1, radix - 1, radix, integer::superdigit(0xFFFFFFFFFFFFFFFF), integer::create("10000000000000000")};
+        for(const std::size_t digits : {1, 2, 3, 40, 700})
+        {
+            values.push_back(random_integer(digits, state));
+        }
+        for(const integer& x : values)
+        {
+            check_chars(x, radix);
+            check_chars(-x, radix);
+        }
+    }
+}
+
+void check_chars_results()
+{
+    integer value = 77;
+    // Nothing to read: no digits, only a sign, or a plus sign (which from_chars does not take), and value is left alone.
+    for(const std::string str : {"", "-", "+5", "z", "-x1"})
+    {
+        const std::from_chars_result result = integer::from_chars(str.data(), str.data() + str.size(), value);
+        CHECK(result.ec == std::errc::invalid_argument and result.ptr == str.data());
+        CHECK(value == 77);
+    }
+    const std::string bad = "101";
+    CHECK(integer::from_chars(bad.data(), bad.data() + 3, value, 1).ec == std::errc::invalid_argument);
+    CHECK(integer::from_chars(bad.data(), bad.data() + 3, value, 37).ec == std::errc::invalid_argument);
+    // Reading stops at the first character that is not a digit of the radix.
+    const std::string partial = "-123456789012345678901234567890a9 rest";
+    std::from_chars_result result = integer::from_chars(partial.data(), partial.data() + partial.size(), value);
+    CHECK(result.ec == std::errc() and result.ptr == partial.data() + 31);
+    CHECK(value == integer::create("-123456789012345678901234567890", 10));
+    result = integer::from_chars(partial.data(), partial.data() + partial.size(), value, 11);
+    CHECK(result.ec == std::errc() and result.ptr == partial.data() + 33);
+    CHECK(value == integer::create("-123456789012345678901234567890a9", 11));
+    result = integer::from_chars(partial.data(), partial.data() + 4, value, 2);
+    CHECK(result.ec == std::errc() and result.ptr == partial.data() + 2 and value == -1);
+    const std::string negative_zero = "-000";
+    CHECK(integer::from_chars(negative_zero.data(), negative_zero.data() + 4, value).ec == std::errc());
+    CHECK(value == 0 and integer::to_string(value, 10) == "0");
+    // to_chars writes all or nothing.
+    char buffer[40];
+    const integer x = integer::create("-123456789012345678901234567890", 10);
+    CHECK(integer::to_chars(buffer, buffer + 30, x).ec == std::errc::value_too_large);
+    CHECK(integer::to_chars(buffer, buffer + 30, x).ptr == buffer + 30);
+    const std::to_chars_result written = integer::to_chars(buffer, buffer + 31, x);
+    CHECK(written.ec == std::errc() and std::string(buffer, written.ptr) == "-123456789012345678901234567890");
+    CHECK(integer::to_chars(buffer, buffer + 2, integer(-5)).ec == std::errc());
+    CHECK(integer::to_chars(buffer, buffer + 1, integer(-5)).ec == std::errc::value_too_large);
+    CHECK(integer::to_chars(buffer, buffer + 40, x, 37).ec == std::errc::invalid_argument);
+}
+
+int main()
+{
+    check_every_radix();
+    check_chars_results();
+    return int_titan::test::result();
+}
@@ -0,0 +1,120 @@
+#include "integer.h"
+#include "tests/test.h"
+#include <string>
+
+using int_titan::integer;
+
+// 10^k.
+integer power_of_ten(const std::size_t k)
+{
+    return integer::create("1" + std::string(k, '0'), 10);
+}
+
+// |x| rounded to 'count' significant digits (ties to even), in the form of approximate_decimal, from its full decimal string.
+std::string rounded_decimal(const integer& x, const std::size_t count)
+{
+    std::string digits = integer::to_string(integer::absolute_value(x), 10);
+    std::size_t exponent = digits.size() - 1;
+    if(digits.size() <= count)
+    {
+        digits += std::string(count - digits.size(), '0');
+    }
+    else
+    {
+        const std::string rest = digits.substr(count);
+        digits.resize(count);
+        const std::string half = "5" + std::string(rest.size() - 1, '0');
+        if(rest > half or (rest == half and (digits.back() - '0') % 2 != 0))
+        {
+            // Add one, carrying through the nines.
+            std::size_t i = count;
+            for(; i > 0 and digits[i - 1] == '9'; i--)
+            {
+                digits[i - 1] = '0';
+            }
+            if(i == 0)
+            {
+                digits = "1" + digits.substr(0, count - 1);
+                exponent++;
+            }
+            else
+            {
+                digits[i - 1]++;
+            }
+        }
+    }
+    std::string result = x < 0 ? "-" : "";
+    result += digits[0];
+    if(count > 1)
+    {
+        result += "." + digits.substr(1);
+    }
+    return result + "e" + std::to_string(exponent);
+}
+
+void check_estimates(const integer& x)
+{
+    const std::size_t digit_count = integer::to_string(integer::absolute_value(x), 10).size();
+    CHECK(integer::decimal_digit_count(x) == digit_count);
+    for(const std::size_t count : {1, 2, 6, 15, 17, 25, 60})
+    {
+        CHECK(integer::approximate_decimal(x, count) == rounded_decimal(x, count));
+    }
+}
+
+void check_powers_of_ten()
+{
+    // Around every power of ten, from within a word to far past it, where the count follows from the bit length but for the values
+    // just around a power of ten.
+    for(std::size_t k = 1; k <= 700; k += k < 40 ? 1 : 37)
+    {
+        const integer power = power_of_ten(k);
+        for(const integer& x : {power - 1, power, power + 1})
+        {
+            check_estimates(x);
+            check_estimates(-x);
+        }
+        CHECK(integer::decimal_digit_count(power - 1) == k);
+        CHECK(integer::decimal_digit_count(power) == k + 1);
+        CHECK(k <= 3 or integer::approximate_decimal(power - 1, 3) == "1.00e" + std::to_string(k));
+        CHECK(integer::approximate_decimal(power + 1, 1) == "1e" + std::to_string(k));
+    }
+    CHECK(integer::decimal_digit_count(0) == 1);
+    CHECK(integer::approximate_decimal(0, 3) == "0.00e0");
+    CHECK(integer::approximate_decimal(integer::shift_bits_left(1, 64), 20) == "1.8446744073709551616e19");
+    CHECK_THROWS(integer::approximate_decimal(5, 0), std::logic_error);
+}
+
+void check_ties()
+{
+    // Exact ties go to the even neighbour, anything above a tie rounds up, at sizes for the long double estimate and beyond it.
+    for(const std::size_t k : {0, 5, 30, 300, 3000})
+    {
+        const integer scale = power_of_ten(k);
+        CHECK(integer::approximate_decimal(1234450 * scale, 5) == "1.2344e" + std::to_string(k + 6));
+        CHECK(integer::approximate_decimal(1234550 * scale, 5) == "1.2346e" + std::to_string(k + 6));
+        CHECK(integer::approximate_decimal(1234450 * scale + 1, 5) == "1.2345e" + std::to_string(k + 6));
+        CHECK(integer::approximate_decimal(-1234450 * scale - 1, 5) == "-1.2345e" + std::to_string(k + 6));
+        CHECK(integer::approximate_decimal(1234549 * scale, 5) == "1.2345e" + std::to_string(k + 6));
+        CHECK(integer::approximate_decimal(9999950 * scale, 5) == "1.0000e" + std::to_string(k + 7));
+        CHECK(integer::approximate_decimal(25 * scale, 1) == "2e" + std::to_string(k + 1));
+        CHECK(integer::approximate_decimal(35 * scale, 1) == "4e" + std::to_string(k + 1));
+        for(const integer& x : {1234450 * scale, 1234550 * scale - 1, 9999950 * scale, 5 * scale, 15 * scale})
+        {
+            check_estimates(x);
+        }
+    }
+    // Values whose top digits sit on a rounding boundary only far below the bits of a long double.
+    const integer tie = (power_of_ten(40) + 5) * power_of_ten(200);
+    CHECK(integer::approximate_decimal(tie, 40) == "1.000000000000000000000000000000000000000e240");
+    CHECK(integer::approximate_decimal(tie + 1, 40) == "1.000000000000000000000000000000000000001e240");
+    CHECK(integer::approximate_decimal(tie - 1, 40) == "1.000000000000000000000000000000000000000e240");
+    CHECK(integer::approximate_decimal(tie, 6) == "1.00000e240");
+}
+
+int main()
+{
+    check_powers_of_ten();
+    check_ties();
+    return int_titan::test::result();
+}
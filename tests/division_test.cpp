@@ -0,0 +1,232 @@
+#include "integer.h"
+#include "tests/test.h"
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using int_titan::integer;
+using int_titan::test::has_negative_sign;
+using int_titan::test::power_of_two;
+using int_titan::test::random_integer;
+
+// Does integer::divide / integer::remainder accept a T divisor?
+template<typename T, typename = void>
+constexpr bool is_word_divisor = false;
+template<typename T>
+constexpr bool is_word_divisor<T, std::void_t<decltype(integer::divide(std::declval<const integer&>(), std::declval<T>()))>> = true;
+template<typename T, typename = void>
+constexpr bool is_word_modulus = false;
+template<typename T>
+constexpr bool is_word_modulus<T, std::void_t<decltype(integer::remainder(std::declval<const integer&>(), std::declval<T>()))>> = true;
+
+// Signed divisors would be taken modulo 2^64 by the word overloads, so they do not compile.
+static_assert(is_word_divisor<unsigned> and is_word_divisor<integer::superdigit> and is_word_modulus<unsigned long long>);
+static_assert(!is_word_divisor<int> and !is_word_divisor<long long> and !is_word_modulus<int> and !is_word_modulus<signed char>);
+
+void check_word_division()
+{
+    const integer x = integer::create("123456789ABCDEF0123456789ABCDEF0123456789");
+    const auto [quotient, remainder] = integer::divide(x, integer::superdigit(0xFEDCBA9876543210));
+    CHECK(quotient == integer::create("1249249249249237FEB1A1F58"));
+    CHECK(remainder == 0xD00CFFD27EA44209);
+    CHECK(integer::remainder(x, 1000000007u) == 358721039u);
+    CHECK(integer::remainder(-x, 1000000007u) == 358721039u);
+    CHECK(integer::divide(-x, 10u).first == -integer::divide(x, 10u).first);
+    CHECK(integer::divide(integer(100), 5u).first == 20);
+    CHECK(integer(100) / -5 == -20);
+    CHECK(integer(100) % -7 == 2);
+    CHECK(integer(-100) % 7 == -2);
+    CHECK_THROWS(integer::divide(x, 0u), std::logic_error);
+    CHECK_THROWS(integer::remainder(x, 0u), std::logic_error);
+}
+
+// |x| / |y| by long division, taking 'block' digits of x at a time from the top. Every partial quotient is then at most 'block' digits
+// long, so with blocks below the Burnikel-Ziegler threshold (96 digits) all of them come from Knuth's algorithm D.
+std::pair<integer, integer> divide_in_blocks(const integer& x, const integer& y, const std::size_t block)
+{
+    const std::size_t bits = 32 * block;
+    const integer mask = integer::shift_bits_left(1, bits) - 1;
+    const integer divisor = integer::absolute_value(y);
+    integer quotient = 0, remainder = 0;
+    for(std::size_t top = (integer::bit_length(x) + bits - 1) / bits * bits; top > 0;)
+    {
+        top -= bits;
+        const integer piece = integer::shift_bits_right(integer::absolute_value(x), top) & mask;
+        const auto [partial_quotient, partial_remainder] = integer::divide(integer::shift_bits_left(remainder, bits) + piece, divisor);
+        quotient = integer::shift_bits_left(quotient, bits) + partial_quotient;
+        remainder = partial_remainder;
+    }
+    return {quotient, remainder};
+}
+
+// q * y + r == x with |r| < |y| (and r taking the sign of x), and the result is that of long division in blocks.
+void check_division(const integer& x, const integer& y, const std::pair<integer, integer>& result, const std::size_t block = 32)
+{
+    const auto& [quotient, remainder] = result;
+    CHECK(quotient * y + remainder == x);
+    CHECK(integer::absolute_value(remainder) < integer::absolute_value(y));
+    CHECK(remainder == 0 or (remainder < 0) == (x < 0));
+    const auto [expected_quotient, expected_remainder] = divide_in_blocks(x, y, block);
+    CHECK(integer::absolute_value(quotient) == expected_quotient);
+    CHECK(integer::absolute_value(remainder) == expected_remainder);
+}
+
+void check_division(const integer& x, const integer& y)
+{
+    check_division(x, y, integer::divide(x, y));
+}
+
+// Signed division truncates towards zero, and the remainder takes the sign of the dividend, as with native integers. This is checked
+// against the division of the magnitudes, with dividends both shorter and longer than the divisor.
+void check_signed_division()
+{
+    integer::superdigit state = 6;
+    for(const std::size_t dividend_digits : {1, 3, 5, 40})
+    {
+        const integer x = random_integer(dividend_digits, state), y = random_integer(3, state);
+        const auto [quotient, remainder] = integer::divide(x, y);
+        CHECK(integer::divide(-x, y) == std::make_pair(-quotient, -remainder));
+        CHECK(integer::divide(x, -y) == std::make_pair(-quotient, remainder));
+        CHECK(integer::divide(-x, -y) == std::make_pair(quotient, -remainder));
+        CHECK(-x / y == -quotient and -x % y == -remainder);
+        CHECK(x / -y == -quotient and x % -y == remainder);
+    }
+    // A dividend of smaller magnitude is the remainder, whatever the signs.
+    const integer x = integer::create("123456789ABCDEF"), y = integer::create("FEDCBA9876543210FEDCBA");
+    CHECK(integer::divide(-x, y) == std::make_pair(integer(0), -x));
+    CHECK(integer::divide(x, -y) == std::make_pair(integer(0), x));
+    CHECK(integer::divide(-x, -y) == std::make_pair(integer(0), -x));
+    CHECK(integer::divide(-y, x).first < 0);
+    // An exact division leaves a zero remainder, which is not negative, whatever the signs.
+    CHECK(integer::divide(integer(-4), integer(2)) == std::make_pair(integer(-2), integer(0)));
+    CHECK(!has_negative_sign(integer::divide(integer(-4), integer(2)).second));
+    CHECK(!has_negative_sign(integer::divide(integer(-4), integer(-2)).second));
+    CHECK(!has_negative_sign(integer::divide(-y * x, x).second));
+    CHECK(!has_negative_sign(-y * x % x));
+}
+
+void check_recursive_division()
+{
+    integer::superdigit state = 1;
+    // Knuth's algorithm below 96 digits of divisor or quotient, Burnikel-Ziegler from there. Divisors of 96 to 191 digits are single
+    // blocks, longer ones are padded to a power of two times a block of 48 to 95 digits.
+    const std::pair<std::size_t, std::size_t> sizes[] = {{95, 300}, {96, 190}, {96, 191}, {96, 300}, {97, 193}, {191, 500}, {192, 400},
+                                                         {200, 1000}, {1000, 2100}, {1500, 1600}};
+    for(const auto& [divisor_digits, dividend_digits] : sizes)
+    {
+        const integer y = random_integer(divisor_digits, state), x = random_integer(dividend_digits, state);
+        check_division(x, y);
+        check_division(-x, y);
+        check_division(x, -y);
+        check_division(y * x, y);
+    }
+    // Divisors of all ones make every trial quotient digit overshoot, at the top level and in the recursion.
+    for(const std::size_t digits : {96, 256})
+    {
+        const integer ones = integer::shift_bits_left(1, 32 * digits) - 1;
+        CHECK(integer::divide(ones * ones + ones - 1, ones) == std::make_pair(ones, ones - 1));
+        check_division(integer::shift_bits_left(1, 32 * 3 * digits) - 1, ones + 2);
+    }
+    // Divisors with a single set bit, which need the most normalization, and dividends just below a multiple of them.
+    const integer power = power_of_two(32 * 150 - 1);
+    check_division(power * random_integer(200, state) - 1, power);
+    check_division(power_of_two(32 * 400), power + 1);
+}
+
+void check_reciprocal_division()
+{
+    integer::superdigit state = 2;
+    // Reciprocals are only precomputed for divisors of 2048 digits and more, the smaller ones falling back to division.
+    for(const std::size_t divisor_digits : {2047, 2048, 2100})
+    {
+        const integer y = random_integer(divisor_digits, state), x = random_integer(5000, state);
+        const integer::reciprocal inverse = integer::reciprocal::create(y);
+        CHECK(inverse.divisor() == y);
+        check_division(x, y, integer::divide(x, inverse));
+        check_division(-x, y, integer::divide(-x, inverse));
+        check_division(x - 1, y, integer::divide(x - 1, inverse));
+        const integer::reciprocal negative_inverse = integer::reciprocal::create(-y);
+        check_division(x, -y, integer::divide(x, negative_inverse));
+        CHECK(integer::divide(y - 1, inverse) == std::make_pair(integer(0), y - 1));
+        CHECK(integer::divide(y * 12345, inverse) == std::make_pair(integer(12345), integer(0)));
+        CHECK(!has_negative_sign(integer::divide(-y * 12345, inverse).second));
+    }
+    CHECK_THROWS(integer::reciprocal::create(0), std::logic_error);
+}
+
+void check_exact_division()
+{
+    integer::superdigit state = 4;
+    const integer ones = integer::shift_bits_left(1, 32 * 40) - 1;
+    // Quotients below 48 digits come from Hensel division alone, longer ones from both ends at once.
+    for(const std::size_t quotient_digits : {1, 47, 48, 49, 100, 301})
+    {
+        for(const std::size_t divisor_digits : {1, 2, 30, 70})
+        {
+            const integer q = random_integer(quotient_digits, state), y = random_integer(divisor_digits, state);
+            // The divisor as is, made odd, and with trailing zero bits and digits (which the dividend shares).
+            for(const integer& divisor : {y, y | 1, integer::shift_bits_left(y | 1, 37), integer::shift_bits_left(y, 64)})
+            {
+                const integer x = q * divisor;
+                CHECK(integer::divide_exact(x, divisor) == q);
+                CHECK(integer::divide_exact(-x, divisor) == -q);
+                CHECK(integer::divide_exact(x, -divisor) == -q);
+                CHECK(integer::divide_exact(x, q) == divisor);
+            }
+        }
+        // Quotients of all ones and of a single set bit carry through the digit where the two halves overlap.
+        const integer all_ones = integer::shift_bits_left(1, 32 * quotient_digits) - 1, top = integer::shift_bits_left(1, 32 * quotient_digits - 1);
+        CHECK(integer::divide_exact(all_ones * ones, ones) == all_ones);
+        CHECK(integer::divide_exact(top * ones, ones) == top);
+        CHECK(integer::divide_exact(all_ones * (ones + 2), ones + 2) == all_ones);
+    }
+    CHECK(integer::divide_exact(0, ones) == 0);
+    // A zero quotient is not negative, whatever the sign of the divisor.
+    CHECK(!has_negative_sign(integer::divide_exact(0, -ones)));
+    CHECK(!has_negative_sign(integer::divide_exact(-integer(0), -3)));
+    CHECK(integer::divide_exact(ones, 1) == ones);
+    CHECK_THROWS(integer::divide_exact(ones, 0), std::logic_error);
+}
+
+void check_word_divisors()
+{
+    integer::superdigit state = 5;
+    // Every amount of normalization, from none (top bit set) to 63 bits, and dividends of odd and even digit counts.
+    std::vector<integer::superdigit> divisors = {1, 2, 3, 10, 0xFFFFFFFF, 0x100000000, 0x100000001, 0x8000000000000000, ~integer::superdigit(0)};
+    for(int shift = 0; shift < 64; shift += 7)
+    {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        divisors.push_back((state | integer::superdigit(1) << 63) >> shift);
+    }
+    for(const std::size_t dividend_digits : {1, 2, 3, 4, 17, 100})
+    {
+        const integer x = random_integer(dividend_digits, state);
+        for(const integer::superdigit y : divisors)
+        {
+            const auto [quotient, remainder] = integer::divide(x, y);
+            CHECK(std::make_pair(quotient, integer(remainder)) == integer::divide(x, integer(y)));
+            CHECK(integer::remainder(x, y) == remainder);
+            CHECK(integer::divide(-x, y) == std::make_pair(-quotient, remainder));
+            CHECK(integer::remainder(-x, y) == remainder);
+        }
+    }
+    CHECK(integer::divide(integer(0), 7u) == std::make_pair(integer(0), integer::superdigit(0)));
+    // A negative dividend smaller than the divisor gives a zero quotient, which is not negative.
+    const auto [zero_quotient, three] = integer::divide(integer(-3), 5u);
+    CHECK(zero_quotient == 0 and three == 3);
+    CHECK(!has_negative_sign(zero_quotient));
+    CHECK(!has_negative_sign(integer::divide(-integer::create("FFFFFFFFFFFFFFFE"), ~integer::superdigit(0)).first));
+    CHECK(integer::remainder(integer(0), ~integer::superdigit(0)) == 0);
+}
+
+int main()
+{
+    check_word_division();
+    check_word_divisors();
+    check_exact_division();
+    check_signed_division();
+    check_recursive_division();
+    check_reciprocal_division();
+    return int_titan::test::result();
+}
@@ -0,0 +1,50 @@
+#include "integer.h"
+#include "tests/test.h"
+#include <cmath>
+#include <limits>
+
+using int_titan::integer;
+using int_titan::test::power_of_two;
+
+// Rounding of values just past the precision of F, which is exact for 2^precision + 1 and 2^precision + 3 in the integer: ties go to
+// the even neighbour, anything above a tie rounds up.
+template<typename F>
+void check_rounding(F (*convert)(const integer&))
+{
+    constexpr int precision = std::numeric_limits<F>::digits;
+    const F base = std::ldexp(F(1), precision);
+    CHECK(convert(power_of_two(precision) + 1) == base);
+    CHECK(convert(power_of_two(precision) + 3) == base + 4);
+    CHECK(convert(-(power_of_two(precision) + 3)) == -(base + 4));
+    // One bit further: 2^(p + 1) + 2 is a tie (down to even), 2^(p + 1) + 3 is above it only by the sticky bit.
+    CHECK(convert(power_of_two(precision + 1) + 2) == 2 * base);
+    CHECK(convert(power_of_two(precision + 1) + 3) == 2 * base + 4);
+    CHECK(convert(power_of_two(precision + 1) + 6) == 2 * base + 8);
+    // The mantissa spans several digits and the sticky bit is far below it.
+    CHECK(convert(power_of_two(precision + 200) + power_of_two(199) + 1) == std::ldexp(base + 1, 200));
+    CHECK(convert(power_of_two(precision + 200) + power_of_two(199)) == std::ldexp(base, 200));
+    CHECK(convert(power_of_two(precision) - 1) == base - 1);
+}
+
+int main()
+{
+    CHECK(integer::to_double(integer(0)) == 0);
+    CHECK(integer::to_double(integer(-12345)) == -12345);
+    CHECK(integer::to_double(integer::create("1000000000000000000000000000000", 10)) == 1e30);
+    CHECK(integer::to_double(integer::create("123456789012345678901234567890123456789", 10)) == 123456789012345678901234567890123456789.0);
+    // The largest double, 2^1024 - 2^971, and the tie above it, which rounds to even, out of range.
+    CHECK(integer::to_double(power_of_two(1024) - power_of_two(971)) == std::numeric_limits<double>::max());
+    CHECK(std::isinf(integer::to_double(power_of_two(1024) - power_of_two(970))));
+    CHECK(integer::to_double(power_of_two(1024) - power_of_two(970) - 1) == std::numeric_limits<double>::max());
+    CHECK(integer::to_double(-power_of_two(1024)) == -std::numeric_limits<double>::infinity());
+    check_rounding<double>(&integer::to_double);
+    check_rounding<long double>(&integer::to_long_double);
+
+    CHECK(integer::from_double(1e30) == integer::create("1000000000000000019884624838656", 10));
+    CHECK(integer::from_double(-2.75) == -2);
+    CHECK(integer::from_double(0.5) == 0);
+    CHECK(integer::from_long_double(std::ldexp(3.0L, 100)) == 3 * power_of_two(100));
+    CHECK_THROWS(integer::from_double(std::numeric_limits<double>::infinity()), std::logic_error);
+    CHECK_THROWS(integer::from_double(std::nan("")), std::logic_error);
+    return int_titan::test::result();
+}
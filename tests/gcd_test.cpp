@@ -0,0 +1,248 @@
+#include "integer.h"
+#include "tests/test.h"
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <vector>
+
+using int_titan::integer;
+using int_titan::test::random_integer;
+
+// Does y divide x (for a non-zero y)?
+bool divides(const integer& y, const integer& x)
+{
+    return x % y == 0;
+}
+
+// g = gcd(x, y) with s x + t y = g: a positive g that divides both and is a combination of them is their greatest common divisor.
+// Unless one of x and y divides the other, the cofactors are those of Euclid's algorithm, within |y| / 2g and |x| / 2g.
+void check_extended_gcd(const integer& x, const integer& y)
+{
+    const auto [g, s, t] = integer::extended_gcd(x, y);
+    CHECK(s * x + t * y == g);
+    CHECK(integer::gcd(x, y) == g);
+    CHECK(integer::gcd(y, x) == g);
+    if(x == 0 and y == 0)
+    {
+        CHECK(g == 0);
+        return;
+    }
+    CHECK(g > 0);
+    CHECK(divides(g, x) and divides(g, y));
+    const integer a = integer::absolute_value(x), b = integer::absolute_value(y);
+    if(a != 0 and b != 0 and !divides(a, b) and !divides(b, a))
+    {
+        CHECK(2 * g * integer::absolute_value(s) <= b);
+        CHECK(2 * g * integer::absolute_value(t) <= a);
+    }
+}
+
+// gcd(|x|, |y|) by Euclid's algorithm with plain division.
+integer euclid_gcd(integer x, integer y)
+{
+    x = integer::absolute_value(x);
+    y = integer::absolute_value(y);
+    while(y != 0)
+    {
+        x = x % y;
+        std::swap(x, y);
+    }
+    return x;
+}
+
+void check_lehmer_gcd()
+{
+    // Small and special values, of all signs.
+    for(const integer& x : {integer(0), integer(1), integer(6), integer(0x100000000u), integer::create("FFFFFFFFFFFFFFFFFFFF")})
+    {
+        for(const integer& y : {integer(0), integer(1), integer(4), integer(35), integer(0x100000000u), integer::create("FFFFFFFFFFFFFFFFFFFF")})
+        {
+            check_extended_gcd(x, y);
+            check_extended_gcd(-x, y);
+            check_extended_gcd(x, -y);
+            check_extended_gcd(-x, -y);
+        }
+    }
+    CHECK(integer::gcd(integer(12), integer(-18)) == 6);
+    CHECK(integer::gcd(integer(-12), integer(-18)) == 6);
+    CHECK(integer::gcd(integer(0), integer(-7)) == 7);
+    CHECK(integer::gcd(integer(0), integer(0)) == 0);
+    // Words, which go to the binary algorithm: against std::gcd, with shared and unshared powers of two.
+    integer::superdigit state = 7;
+    std::vector<integer::superdigit> words = {0, 1, 2, 3, 1ull << 63, 3ull << 62, 0xFFFFFFFF, 0x100000000, ~0ull, ~0ull - 1};
+    for(int i = 0; i < 20; i++)
+    {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        words.push_back(state >> (i % 3 == 0 ? 0 : 7 * i % 64));
+        words.push_back((state << (i % 40)) | (i % 5 == 0 ? 0 : 1ull << 63));
+    }
+    for(const integer::superdigit x : words)
+    {
+        for(const integer::superdigit y : words)
+        {
+            CHECK(integer::gcd(x, y) == std::gcd(x, y));
+            CHECK(integer::gcd(-integer(x), y) == std::gcd(x, y));
+        }
+    }
+    // A zero operand, whatever the size and sign of the other.
+    const integer big = random_integer(700, state);
+    CHECK(integer::gcd(0, big) == big and integer::gcd(big, 0) == big);
+    CHECK(integer::gcd(0, -big) == big and integer::gcd(-big, 0) == big);
+    // Consecutive Fibonacci numbers take the most steps, all of them with quotient 1.
+    integer a = 1, b = 1;
+    for(int i = 0; i < 3000; i++)
+    {
+        a += b;
+        std::swap(a, b);
+    }
+    check_extended_gcd(b, a);
+    check_extended_gcd(a * 1000003, b * 1000003);
+    // Quotients too large for the cofactors of a Lehmer step, which fall back to a division step.
+    for(const std::size_t bits : {31, 32, 33, 62, 64, 200})
+    {
+        const integer y = random_integer(30, state), q = integer::shift_bits_left(1, bits) + 12345;
+        CHECK(integer::gcd(y * q + 17 * q, y) == euclid_gcd(17 * q, y));
+        check_extended_gcd(y * q + 1, y);
+    }
+    // Operands of very different sizes (so the first step is a division), and of close sizes, below the half-gcd threshold.
+    const std::pair<std::size_t, std::size_t> sizes[] = {{2, 1}, {3, 1}, {3, 3}, {40, 39}, {300, 100}, {1500, 1}, {1500, 2}, {1500, 3},
+                                                         {1500, 40}, {1000, 999}};
+    for(const auto& [x_digits, y_digits] : sizes)
+    {
+        const integer x = random_integer(x_digits, state), y = random_integer(y_digits, state);
+        CHECK(integer::gcd(x, y) == euclid_gcd(x, y));
+        CHECK(integer::gcd(-y, x) == euclid_gcd(x, y));
+        check_extended_gcd(x, y);
+        check_extended_gcd(y, -x);
+        const integer factor = random_integer(std::max<std::size_t>(y_digits / 3, 1), state);
+        CHECK(integer::gcd(x * factor, y * factor) == euclid_gcd(x, y) * factor);
+        check_extended_gcd(x * factor, x * factor + factor);
+        check_extended_gcd(x * y, y);
+    }
+}
+
+void check_gcd()
+{
+    // Lehmer's algorithm below 2048 digits, the half-gcd algorithm from there, with a large common factor or none, balanced or not.
+    integer::superdigit state = 1;
+    const std::pair<std::size_t, std::size_t> sizes[] = {{2047, 2040}, {2048, 2048}, {3000, 2900}, {2500, 300}};
+    for(const auto& [x_digits, y_digits] : sizes)
+    {
+        const integer x = random_integer(x_digits, state), y = random_integer(y_digits, state);
+        check_extended_gcd(x, y);
+        check_extended_gcd(y, -x);
+        const integer factor = random_integer(std::max<std::size_t>(x_digits / 3, 1), state);
+        check_extended_gcd(x * factor, y * factor);
+        check_extended_gcd(x * factor, x * factor + factor);
+        check_extended_gcd(x * y, y);
+    }
+}
+
+// The value of a continued fraction, as a numerator and a positive denominator (which are coprime).
+std::pair<integer, integer> evaluate(const std::vector<integer>& terms)
+{
+    integer numerator = terms.back(), denominator = 1;
+    for(std::size_t i = terms.size() - 1; i-- > 0;)
+    {
+        const integer next = terms[i] * numerator + denominator;
+        denominator = numerator;
+        numerator = next;
+    }
+    return {numerator, denominator};
+}
+
+// The continued fraction of x / y has the value of x / y, and after the first term (x / y rounded down) positive terms, the last one
+// above 1.
+void check_continued_fraction(const integer& x, const integer& y)
+{
+    const std::vector<integer> terms = integer::continued_fraction(x, y);
+    const integer g = integer::gcd(x, y);
+    const auto [numerator, denominator] = evaluate(terms);
+    CHECK(numerator == (y < 0 ? -x : x) / g);
+    CHECK(denominator == integer::absolute_value(y) / g);
+    for(std::size_t i = 1; i < terms.size(); i++)
+    {
+        CHECK(terms[i] > 0);
+    }
+    CHECK(terms.size() == 1 or terms.back() > 1);
+}
+
+void check_continued_fractions()
+{
+    CHECK(integer::continued_fraction(415, 93) == std::vector<integer>{4, 2, 6, 7});
+    CHECK(integer::continued_fraction(-415, 93) == std::vector<integer>{-5, 1, 1, 6, 7});
+    CHECK(integer::continued_fraction(415, -93) == std::vector<integer>{-5, 1, 1, 6, 7});
+    CHECK(integer::continued_fraction(93, 415) == std::vector<integer>{0, 4, 2, 6, 7});
+    CHECK(integer::continued_fraction(12, 4) == std::vector<integer>{3});
+    CHECK(integer::continued_fraction(0, 5) == std::vector<integer>{0});
+    CHECK_THROWS(integer::continued_fraction(5, 0), std::logic_error);
+    // 2^k / (2^k - 1) is [1; 2^k - 1], and consecutive Fibonacci numbers give terms of 1 only.
+    const integer power = integer::shift_bits_left(1, 5000);
+    CHECK(integer::continued_fraction(power, power - 1) == std::vector<integer>{1, power - 1});
+    integer a = 1, b = 2;
+    for(int i = 0; i < 500; i++)
+    {
+        a += b;
+        std::swap(a, b);
+    }
+    const std::vector<integer> terms = integer::continued_fraction(b, a);
+    CHECK(terms.size() == 501 and terms.back() == 2);
+    CHECK(std::count(terms.begin(), terms.end(), integer(1)) == 500);
+    // Quotients of Lehmer's and of the half-gcd algorithm, including ones much larger than a digit.
+    integer::superdigit state = 2;
+    for(const std::size_t digits : {1, 2, 50, 2048, 2600})
+    {
+        const integer x = random_integer(digits, state), y = random_integer(digits, state);
+        check_continued_fraction(x, y);
+        check_continued_fraction(-y, x);
+        check_continued_fraction(x * random_integer(digits / 2 + 1, state) + y, x);
+    }
+}
+
+// The inverse of x modulo m exists exactly when they are coprime, and is then the one in [0, |m|).
+void check_mod_inverse(const integer& x, const integer& m)
+{
+    const std::optional<integer> inverse = integer::mod_inverse(x, m);
+    const integer modulus = integer::absolute_value(m);
+    CHECK(inverse.has_value() == (integer::gcd(x, m) == 1 or modulus == 1));
+    if(inverse)
+    {
+        CHECK(*inverse >= 0 and *inverse < modulus);
+        const integer product = (x * *inverse) % modulus;
+        CHECK(product == (modulus == 1 ? 0 : x < 0 ? 1 - modulus : 1));
+    }
+}
+
+void check_mod_inverses()
+{
+    integer::superdigit state = 3;
+    // Odd moduli of a word are inverted by the binary algorithm, the rest through the cofactors of Euclid's algorithm.
+    const integer moduli[] = {1, 2, 3, 15, 1000000007, 0x100000000u, integer::create("1FFFFFFFFFFFFFFF"), integer::create("FFFFFFFFFFFFFFC5"),
+                              integer::create("FFFFFFFFFFFFFFFF"), integer::create("DE0B6B3A7640000"), integer::create("10000000000000001"),
+                              random_integer(50, state) | 1, random_integer(50, state) << 1, random_integer(2100, state)};
+    for(const integer& m : moduli)
+    {
+        for(const integer& x : {integer(0), integer(1), integer(2), integer(3), integer(5), m - 1, m + 1, m * 3 + 7, random_integer(3, state),
+                                random_integer(60, state)})
+        {
+            check_mod_inverse(x, m);
+            check_mod_inverse(-x, m);
+            check_mod_inverse(x, -m);
+        }
+    }
+    CHECK(integer::mod_inverse(3, 7) == integer(5));
+    CHECK(integer::mod_inverse(-3, 7) == integer(2));
+    CHECK(integer::mod_inverse(6, 9) == std::nullopt);
+    CHECK(integer::mod_inverse(0, 1) == integer(0));
+    CHECK_THROWS(integer::mod_inverse(3, 0), std::logic_error);
+}
+
+int main()
+{
+    check_lehmer_gcd();
+    check_gcd();
+    check_continued_fractions();
+    check_mod_inverses();
+    return int_titan::test::result();
+}
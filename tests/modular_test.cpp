@@ -0,0 +1,175 @@
+#include "integer.h"
+#include "tests/test.h"
+
+using int_titan::integer;
+using int_titan::test::power_of_two;
+using int_titan::test::random_integer;
+
+// x mod m, in [0, m).
+integer modulo(const integer& x, const integer& m)
+{
+    const integer r = x % m;
+    return r < 0 ? r + m : r;
+}
+
+// base^exponent mod m by repeated squaring, with plain division.
+integer naive_powmod(integer base, integer exponent, const integer& m)
+{
+    integer result = modulo(1, m);
+    base = modulo(base, m);
+    for(; exponent != 0; exponent >>= 1)
+    {
+        if(integer::test_bit(exponent, 0))
+        {
+            result = result * base % m;
+        }
+        base = base * base % m;
+    }
+    return result;
+}
+
+void check_montgomery(const integer& m, const std::size_t words)
+{
+    const integer::montgomery_context context = integer::montgomery_context::create(m);
+    const integer r = power_of_two(64 * words), r_inverse = *integer::mod_inverse(r, m);
+    CHECK(context.modulus() == m);
+    const integer x = modulo(-12345, m), y = (m >> 3) * 5 + 7;
+    const integer x_form = context.to_montgomery(x), y_form = context.to_montgomery(y);
+    CHECK(x_form == modulo(x * r, m));
+    CHECK(context.from_montgomery(x_form) == x);
+    CHECK(context.to_montgomery(-x) == modulo(-x * r, m));
+    CHECK(context.from_montgomery(context.montmul(x_form, y_form)) == modulo(x * y, m));
+    CHECK(context.from_montgomery(context.montsqr(y_form)) == modulo(y * y, m));
+    CHECK(context.montmul(x, y) == modulo(x * y * r_inverse, m));
+    // REDC takes anything below m * R, the largest value included, and nothing from there.
+    const integer largest = m * r - 1;
+    CHECK(context.redc(largest) == modulo(largest * r_inverse, m));
+    CHECK(context.redc(0) == 0);
+    // A negative zero (such as the remainder of a negative multiple of m) is zero, not a negative value.
+    CHECK(context.redc(integer::create(integer::integer_digits(), true)) == 0);
+    CHECK(context.redc(-m * 3 % m) == 0);
+    CHECK_THROWS(context.redc(m * r), std::logic_error);
+    CHECK_THROWS(context.redc(r * r - 1), std::logic_error);
+    CHECK_THROWS(context.redc(-1), std::logic_error);
+    const integer exponent = integer::create("F00DFACE0123456789ABCDEF0123456789", 16);
+    CHECK(context.powmod(x, exponent) == naive_powmod(x, exponent, m));
+    CHECK(context.powmod(-y, 3) == modulo(-y * y * y, m));
+    CHECK(context.powmod(x, 0) == 1);
+    CHECK_THROWS(context.powmod(x, -1), std::logic_error);
+}
+
+void check_montgomery_sizes()
+{
+    // The word counts with unrolled kernels, and others. Moduli just above a power of 2^64 leave the widest gap between m * R and
+    // R^2, and those just below it the narrowest.
+    for(const std::size_t words : {1, 4, 5, 8, 16, 32, 64})
+    {
+        check_montgomery(power_of_two(64 * words - 63) + 1, words);
+        check_montgomery(power_of_two(64 * words) - 59, words);
+        check_montgomery(integer::create(std::string(16 * words - 1, '9') + "7", 16), words);
+    }
+    CHECK_THROWS(integer::montgomery_context::create(integer(10)), std::logic_error);
+    CHECK_THROWS(integer::montgomery_context::create(integer(0)), std::logic_error);
+}
+
+void check_barrett(const integer& m)
+{
+    const integer::barrett_context context = integer::barrett_context::create(m);
+    CHECK(context.modulus() == m);
+    const integer x = m * m - 1, y = (m >> 1) + 12345;
+    CHECK(context.reduce(x) == modulo(x, m));
+    CHECK(context.reduce(-x) == modulo(-x, m));
+    CHECK(context.reduce(x * x * 3) == modulo(x * x * 3, m));
+    CHECK(context.mulmod(x, -y) == modulo(-x * y, m));
+    const integer exponent = integer::create("DEADBEEF0123456789ABCDEF0123456789", 16);
+    CHECK(context.powmod(y, exponent) == naive_powmod(y, exponent, m));
+    CHECK(context.powmod(-y, 5) == modulo(-y * y * y * y * y, m));
+    CHECK(context.powmod(y, 0) == modulo(1, m));
+    CHECK(integer::powmod(y, exponent, -m) == naive_powmod(y, exponent, m));
+}
+
+// Barrett reduction against % for values of every length, from below the modulus to many times its size.
+void check_barrett_reduce()
+{
+    integer::superdigit state = 1;
+    for(const std::size_t digits : {1, 2, 5, 31, 32, 33, 70})
+    {
+        for(const integer& m : {random_integer(digits, state), power_of_two(32 * (digits - 1)), power_of_two(32 * digits) - 1})
+        {
+            const integer::barrett_context context = integer::barrett_context::create(m);
+            CHECK(context.reduce(0) == 0);
+            CHECK(context.reduce(m) == 0);
+            CHECK(context.reduce(m - 1) == m - 1);
+            CHECK(context.reduce(-m) == 0);
+            CHECK(context.reduce(-1) == m - 1);
+            // Up to 2k digits take a single window, longer values one more per k digits (the last one partial).
+            for(const std::size_t length : {digits, 2 * digits - 1, 2 * digits, 2 * digits + 1, 3 * digits, 5 * digits + 3})
+            {
+                const integer x = random_integer(length, state), ones = power_of_two(32 * length) - 1;
+                CHECK(context.reduce(x) == x % m);
+                CHECK(context.reduce(-x) == modulo(-x, m));
+                CHECK(context.reduce(ones) == ones % m);
+                CHECK(context.reduce(x * m) == 0);
+                CHECK(context.reduce(x * m - 1) == m - 1);
+            }
+        }
+    }
+}
+
+void check_barrett_sizes()
+{
+    // Powers of 2^32 have the longest scaled reciprocal (k + 2 digits), and 32 digits and more are multiplied by Karatsuba's method.
+    for(const std::size_t digits : {1, 2, 3, 31, 32, 40})
+    {
+        check_barrett(power_of_two(32 * (digits - 1)));
+        check_barrett(power_of_two(32 * (digits - 1)) * 2 + 2);
+        check_barrett(power_of_two(32 * digits) - 2);
+        check_barrett(integer::create(std::string(8 * digits - 1, 'B') + "6", 16));
+    }
+    check_barrett(1);
+    CHECK_THROWS(integer::barrett_context::create(0), std::logic_error);
+    CHECK_THROWS(integer::powmod(3, 4, 0), std::logic_error);
+}
+
+void check_powmod()
+{
+    // Fermat's little theorem for Mersenne primes (of one, two and nine words), and Euler's for powers of two (Barrett).
+    for(const std::size_t p : {61, 127, 521})
+    {
+        const integer prime = power_of_two(p) - 1;
+        for(const integer& base : {integer(2), integer(3), integer(-5), integer::create("123456789ABCDEF0123456789ABCDEF")})
+        {
+            CHECK(integer::powmod(base, prime - 1, prime) == 1);
+            CHECK(integer::powmod(base, prime, prime) == modulo(base, prime));
+        }
+    }
+    for(const std::size_t k : {3, 64, 100, 1100})
+    {
+        CHECK(integer::powmod(3, power_of_two(k - 2), power_of_two(k)) == 1);
+        CHECK(integer::powmod(-3, power_of_two(k - 2) + 1, power_of_two(k)) == power_of_two(k) - 3);
+    }
+    // Exponents of every window width (1 to 6 bits), against square-and-multiply.
+    const integer odd = integer::create("F123456789ABCDEF0123456789ABCDEF0123456789ABCDEF1"), even = odd + 1;
+    for(const std::size_t bits : {1, 5, 23, 24, 79, 80, 239, 240, 671, 672, 2000})
+    {
+        const integer exponent = power_of_two(bits - 1) + (power_of_two(bits) - 1) / 3;
+        CHECK(integer::powmod(odd - 2, exponent, odd) == naive_powmod(odd - 2, exponent, odd));
+        CHECK(integer::powmod(odd - 2, exponent, even) == naive_powmod(odd - 2, exponent, even));
+    }
+    CHECK(integer::powmod(0, 0, 7) == 1);
+    CHECK(integer::powmod(0, 5, 7) == 0);
+    CHECK(integer::powmod(14, 3, 7) == 0);
+    CHECK(integer::powmod(5, 3, 1) == 0);
+    CHECK(integer::powmod(5, 0, 1) == 0);
+    CHECK_THROWS(integer::powmod(5, -1, 7), std::logic_error);
+    CHECK_THROWS(integer::powmod(5, -1, 8), std::logic_error);
+}
+
+int main()
+{
+    check_montgomery_sizes();
+    check_barrett_reduce();
+    check_barrett_sizes();
+    check_powmod();
+    return int_titan::test::result();
+}
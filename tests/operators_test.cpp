@@ -0,0 +1,206 @@
+#include "integer.h"
+#include "tests/test.h"
+#include <cstdint>
+#include <limits>
+#include <string>
+
+using int_titan::integer;
+using int_titan::test::has_negative_sign;
+
+// x < y, checked with every comparison operator in both directions.
+void check_less(const integer& x, const integer& y)
+{
+    CHECK(x < y);
+    CHECK(x <= y);
+    CHECK(!(x > y));
+    CHECK(!(x >= y));
+    CHECK(y > x);
+    CHECK(y >= x);
+    CHECK(!(y < x));
+    CHECK(!(y <= x));
+    CHECK(x != y);
+}
+
+void check_comparisons()
+{
+    const integer big = integer::create("100000000000000000000000000");
+    check_less(integer(-3), integer(-2));
+    check_less(-big, integer(-1));
+    check_less(integer(-1), integer(0));
+    check_less(integer(0), integer(1));
+    check_less(integer(7), big);
+    check_less(big, big + 1);
+    check_less(-(big + 1), -big);
+    for(const integer& x : {integer(0), integer(-5), big})
+    {
+        CHECK(x <= x);
+        CHECK(x >= x);
+        CHECK(!(x < x));
+        CHECK(!(x > x));
+    }
+    CHECK(integer::is_less_than(integer(0), integer(0), false));
+    CHECK(!integer::is_less_than(integer(0), integer(0)));
+    // Mixed with native integers, on either side.
+    CHECK(integer(-1) < 0u);
+    CHECK(0u > integer(-1));
+    CHECK(big > std::numeric_limits<std::uint64_t>::max());
+    CHECK(std::numeric_limits<std::int64_t>::min() < integer(std::numeric_limits<std::int64_t>::min()) + 1);
+    CHECK(integer(std::numeric_limits<std::int64_t>::min()) == std::numeric_limits<std::int64_t>::min());
+    CHECK(5 <= integer(5) and integer(5) >= 5);
+}
+
+void check_arithmetic()
+{
+    // Carries and borrows across whole digits, and subtraction of negatives either way round.
+    CHECK(integer::create("FFFFFFFFFFFFFFFF") + 1 == integer::create("10000000000000000"));
+    CHECK(integer::create("10000000000000000") - 1 == integer::create("FFFFFFFFFFFFFFFF"));
+    CHECK(integer(-3) - integer(-5) == 2);
+    CHECK(integer(-5) - integer(-3) == -2);
+    CHECK(integer(3) - integer(5) == -2);
+    // Mixed operators.
+    integer x = integer::create("123456789ABCDEF0123456789");
+    CHECK(x + 1 - 1 == x);
+    CHECK(1 - x == -(x - 1));
+    // A native minus an equal integer is 0, not a negative zero.
+    CHECK(5 - integer(5) == 0 and !has_negative_sign(5 - integer(5)));
+    CHECK(!has_negative_sign(-5 - integer(-5)));
+    CHECK(!has_negative_sign(~0ull - integer(~0ull)));
+    CHECK(!has_negative_sign(std::numeric_limits<std::int64_t>::min() - integer(std::numeric_limits<std::int64_t>::min())));
+    CHECK(x * -3 == -(x + x + x));
+    CHECK(-3 * x == x * integer(-3));
+    CHECK(x * 0 == 0);
+    x += 10;
+    x -= 20;
+    x *= 2;
+    CHECK(x == integer::create("2468ACF13579BDE02468ACEFE"));
+    // Division truncates towards zero, and the remainder has the sign of the dividend.
+    CHECK(integer(-7) / 2 == -3 and integer(-7) % 2 == -1);
+    CHECK(integer(7) / -2 == -3 and integer(7) % -2 == 1);
+    CHECK(integer::divide(integer(-7), integer(2)) == std::make_pair(integer(-3), integer(-1)));
+    CHECK(integer::divide(integer(7), integer(-2)) == std::make_pair(integer(-3), integer(1)));
+    CHECK(integer::divide(integer(-7), integer(-2)) == std::make_pair(integer(3), integer(-1)));
+    CHECK(integer::divide(integer(-1), integer(5)) == std::make_pair(integer(0), integer(-1)));
+}
+
+// Digit sums and differences that wrap, and comparisons of negative values (each of which the baseline got wrong).
+void check_carries_and_borrows()
+{
+    const integer ones = integer::create("FFFFFFFFFFFFFFFFFFFFFFFF"), power = ones + 1;
+    // y_i + carry wraps to 0 when y_i is all ones, which must still carry into the next digit.
+    CHECK(ones + ones == integer::create("1FFFFFFFFFFFFFFFFFFFFFFFE"));
+    CHECK(integer::add(ones, integer(1)) == integer::create("1000000000000000000000000"));
+    CHECK(integer::add(integer::create("100000001"), integer::create("FFFFFFFFFFFFFFFF")) == integer::create("10000000100000000"));
+    // A borrow through zero digits.
+    CHECK(integer::subtract(power, integer(1)) == ones);
+    CHECK(integer::subtract(integer::create("100000000000000000000000001"), integer::create("2")) == integer::create("FFFFFFFFFFFFFFFFFFFFFFFFFF"));
+    CHECK(integer::subtract(power, ones) == 1);
+    // (-a) - (-b) = b - a, with |a| above and below |b|.
+    CHECK(integer::subtract(-ones, -power) == 1);
+    CHECK(integer::subtract(-power, -ones) == -1);
+    CHECK(integer::subtract(-integer(3), -power) == power - 3);
+    CHECK(integer::subtract(-power, -integer(3)) == 3 - power);
+    CHECK(integer::subtract(-power, -power) == 0);
+    // Negatives compare by reversed magnitude, and 'strict' decides equal ones.
+    CHECK(integer::is_less_than(-power, -ones));
+    CHECK(!integer::is_less_than(-ones, -power));
+    CHECK(integer::is_less_than(-power, -ones, false));
+    CHECK(!integer::is_less_than(-ones, -power, false));
+    CHECK(!integer::is_less_than(-ones, -ones));
+    CHECK(integer::is_less_than(-ones, -ones, false));
+}
+
+// x * y the schoolbook way, from the products of x with each digit of y (which take the single-word path).
+integer multiply_by_digits(const integer& x, const integer& y)
+{
+    integer result = 0, rest = integer::absolute_value(y);
+    for(std::size_t shift = 0; rest != 0; shift += 32)
+    {
+        const auto [high, low] = integer::divide(rest, integer::superdigit(1) << 32);
+        result += integer::shift_bits_left(x * low, shift);
+        rest = high;
+    }
+    return y < 0 ? -result : result;
+}
+
+void check_multiplication()
+{
+    // Operands on both sides of the Karatsuba threshold (32 digits), balanced and not, with carries through whole digits.
+    for(const std::size_t digits : {31, 32, 33, 64, 100, 257})
+    {
+        const integer x = integer::shift_bits_left(1, 32 * digits) - 1;
+        const integer y = integer::create(std::string(8 * digits - 3, 'B') + "A7", 16) * 3 + 1;
+        CHECK(x * y == multiply_by_digits(x, y));
+        CHECK(y * -x == -multiply_by_digits(x, y));
+        CHECK(x * x == integer::shift_bits_left(1, 64 * digits) - integer::shift_bits_left(1, 32 * digits + 1) + 1);
+        const integer short_y = integer::create(std::string(8 * digits / 3 + 8, '9'), 16);
+        CHECK(x * short_y == multiply_by_digits(x, short_y));
+    }
+    CHECK(integer::shift_bits_left(1, 4000) * 0 == 0);
+}
+
+void check_conversions()
+{
+    CHECK(integer::to<int>(integer(-42)) == -42);
+    CHECK(integer::to<std::int64_t>(integer(std::numeric_limits<std::int64_t>::min())) == std::numeric_limits<std::int64_t>::min());
+    CHECK(integer::to<std::uint64_t>(integer(std::numeric_limits<std::uint64_t>::max())) == std::numeric_limits<std::uint64_t>::max());
+    CHECK_THROWS(integer::to<std::uint8_t>(integer(256)), std::overflow_error);
+    CHECK_THROWS(integer::to<unsigned>(integer(-1)), std::overflow_error);
+    CHECK_THROWS(integer::to<std::int32_t>(integer(std::int64_t(1) << 31)), std::overflow_error);
+    CHECK(integer::to<std::int32_t>(-integer(std::int64_t(1) << 31)) == std::numeric_limits<std::int32_t>::min());
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 wide = (static_cast<unsigned __int128>(0x0123456789ABCDEF) << 64) | 0xFEDCBA9876543210;
+    CHECK(integer(wide) == integer::create("123456789ABCDEFFEDCBA9876543210"));
+    CHECK(integer::to<unsigned __int128>(integer(wide)) == wide);
+    CHECK(integer(wide) / integer(wide) == 1);
+    CHECK_THROWS(integer::to<__int128>(integer(wide) * integer(wide)), std::overflow_error);
+#endif
+}
+
+// The limits of T convert both ways, and one past them does not.
+template<typename T>
+void check_native_limits()
+{
+    constexpr T low = std::numeric_limits<T>::min(), high = std::numeric_limits<T>::max();
+    CHECK(integer::to<T>(integer(low)) == low);
+    CHECK(integer::to<T>(integer(high)) == high);
+    CHECK(integer::to<T>(integer(T(0))) == T(0));
+    CHECK(integer::to<T>(integer(high) - 1) == T(high - 1));
+    CHECK(integer::to<T>(integer(low) + 1) == T(low + 1));
+    CHECK(integer(high) - integer(low) + 1 == integer::shift_bits_left(1, std::numeric_limits<T>::digits + (low < 0 ? 1 : 0)));
+    CHECK_THROWS(integer::to<T>(integer(high) + 1), std::overflow_error);
+    CHECK_THROWS(integer::to<T>(integer(low) - 1), std::overflow_error);
+    CHECK_THROWS(integer::to<T>(integer::shift_bits_left(integer(high), 64)), std::overflow_error);
+    CHECK_THROWS(integer::to<T>(-integer::shift_bits_left(integer(high), 64)), std::overflow_error);
+}
+
+void check_native_types()
+{
+    check_native_limits<signed char>();
+    check_native_limits<unsigned char>();
+    check_native_limits<short>();
+    check_native_limits<unsigned short>();
+    check_native_limits<int>();
+    check_native_limits<unsigned>();
+    check_native_limits<long>();
+    check_native_limits<unsigned long>();
+    check_native_limits<long long>();
+    check_native_limits<unsigned long long>();
+#if defined(__SIZEOF_INT128__)
+    check_native_limits<__int128>();
+    check_native_limits<unsigned __int128>();
+#endif
+    CHECK(integer(char(65)) == 65);
+    CHECK(integer(static_cast<std::int8_t>(-128)) == -128);
+    CHECK(integer(-0) == 0 and integer::to_string(integer(-0), 10) == "0");
+}
+
+int main()
+{
+    check_comparisons();
+    check_arithmetic();
+    check_carries_and_borrows();
+    check_multiplication();
+    check_conversions();
+    check_native_types();
+    return int_titan::test::result();
+}
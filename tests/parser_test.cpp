@@ -0,0 +1,105 @@
+#include "integer.h"
+#include "tests/test.h"
+#include <sstream>
+#include <string>
+#include <string_view>
+
+using int_titan::integer;
+
+// A string of 'count' digits of a radix, cycling through all of them, that starts with a non-zero one.
+std::string digit_string(const std::size_t count, const int radix)
+{
+    static constexpr char characters[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    std::string str;
+    for(std::size_t i = 0; i < count; i++)
+    {
+        str += characters[(i * 7 + 1) % radix];
+    }
+    return str;
+}
+
+// Parse a string fed in pieces of 'piece' characters.
+integer parse_in_pieces(const std::string& str, const std::size_t piece, const int radix)
+{
+    integer::parser p = integer::parser::create(radix);
+    for(std::size_t i = 0; i < str.size(); i += piece)
+    {
+        CHECK(p.feed(std::string_view(str).substr(i, piece)) == std::min(piece, str.size() - i));
+    }
+    return p.finish();
+}
+
+void check_chunk_boundaries()
+{
+    // A decimal chunk is 19 characters and a chunk of radix 3 is 40, so the lengths and pieces land on either side of the chunk
+    // boundaries; radix 16 goes through the packing of bits instead.
+    for(const int radix : {10, 3, 36, 16, 2})
+    {
+        for(const std::size_t length : {1, 18, 19, 20, 39, 40, 41, 1000, 5000})
+        {
+            const std::string str = digit_string(length, radix);
+            const integer expected = integer::create(str, radix);
+            for(const std::size_t piece : {1, 7, 19, 20, 40, 4096})
+            {
+                CHECK(parse_in_pieces(str, piece, radix) == expected);
+                CHECK(parse_in_pieces("-" + str, piece, radix) == -expected);
+            }
+        }
+    }
+    // The parser starts over after finish.
+    integer::parser p = integer::parser::create(10);
+    p.feed("123");
+    CHECK(p.finish() == 123);
+    p.feed("-4");
+    CHECK(p.finish() == -4);
+}
+
+void check_streams()
+{
+    // Terms longer than the 4096 characters read at a time, with the operator after each one left in the stream.
+    const std::string first = digit_string(4096, 10), second = digit_string(9000, 10);
+    std::istringstream in("  " + first + "+\n-" + second + "=");
+    integer::parser p = integer::parser::create(10);
+    p.read(in);
+    CHECK(p.finish() == integer::create(first, 10));
+    CHECK(in.get() == '+');
+    p.read(in);
+    CHECK(p.finish() == -integer::create(second, 10));
+    CHECK(in.get() == '=');
+    // Read from a source of pieces, where only whitespace may follow the number.
+    const std::string pieces[] = {"12345678901234567", "890123", "4567 \n", ""};
+    std::size_t next = 0;
+    p.read_chunks([&]() { return std::string_view(pieces[next++]); });
+    CHECK(p.finish() == integer::create("123456789012345678901234567", 10));
+}
+
+void check_invalid_input()
+{
+    // Parsing stops at the first character that is not a digit of the radix, and nothing after it is taken.
+    integer::parser p = integer::parser::create(8);
+    CHECK(p.feed("1278") == 3);
+    CHECK(p.feed("1") == 0);
+    CHECK(p.finish() == 0127);
+    // A missing term.
+    CHECK_THROWS(p.finish(), std::logic_error);
+    p.feed("-");
+    CHECK_THROWS(p.finish(), std::logic_error);
+    std::istringstream in("*2=");
+    p.read(in);
+    CHECK_THROWS(p.finish(), std::logic_error);
+    CHECK(in.get() == '*');
+    // Sources may end with whitespace only.
+    const std::string pieces[] = {"1234", "5x6", ""};
+    std::size_t next = 0;
+    integer::parser decimal = integer::parser::create(10);
+    CHECK_THROWS(decimal.read_chunks([&]() { return std::string_view(pieces[next++]); }), std::logic_error);
+    CHECK_THROWS(integer::parser::create(37), std::logic_error);
+}
+
+int main()
+{
+    check_chunk_boundaries();
+    check_streams();
+    check_invalid_input();
+    return int_titan::test::result();
+}
@@ -0,0 +1,204 @@
+#include "integer.h"
+#include "tests/test.h"
+#include <string>
+#include <vector>
+
+using int_titan::integer;
+using int_titan::test::random_integer;
+
+// The value of a string of digits modulo a word, by Horner's rule on native words, which is independent of the conversions.
+integer::superdigit string_remainder(const std::string& str, const int radix, const integer::superdigit m)
+{
+    integer::superdigit r = 0;
+    for(const char c : str)
+    {
+        if(c == '-')
+        {
+            continue;
+        }
+        const int d = c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+        r = (r * radix + d) % m;
+    }
+    return r;
+}
+
+// x in a radix: the string has no leading zeroes and the same value modulo some primes, and it converts back to x by every path.
+void check_round_trip(const integer& x, const int radix)
+{
+    const std::string upper = integer::to_string(x, radix), lower = integer::to_string(x, radix, false);
+    CHECK(upper.size() == lower.size());
+    CHECK(integer::create(upper, radix) == x);
+    CHECK(integer::create(lower, radix) == x);
+    CHECK((x < 0) == (upper[0] == '-'));
+    CHECK(upper[x < 0 ? 1 : 0] != '0' or upper == "0");
+    for(const integer::superdigit p : {integer::superdigit(1000000007), integer::superdigit(4294967291u), integer::superdigit(65521)})
+    {
+        CHECK(integer::remainder(x, p) == string_remainder(upper, radix, p));
+    }
+}
+
+void check_every_radix()
+{
+    integer::superdigit state = 1;
+    for(int radix = 2; radix <= 36; radix++)
+    {
+        // Powers of the radix and their neighbours, and values of a single chunk up to well past the 32 chunks converted one by one.
+        integer power = 1;
+        for(int i = 0; i < 70; i++)
+        {
+            for(const integer& x : {power - 1, power, power + 1})
+            {
+                check_round_trip(x, radix);
+                check_round_trip(-x, radix);
+            }
+            power *= radix;
+        }
+        for(const std::size_t digits : {1, 2, 3, 10, 40, 300, 1500})
+        {
+            const integer x = random_integer(digits, state);
+            check_round_trip(x, radix);
+            check_round_trip(-x, radix);
+        }
+        CHECK(integer::to_string(0, radix) == "0");
+        CHECK(integer::to_string(-power, radix) == "-1" + std::string(70, '0'));
+        CHECK(integer::create("-0", radix) == 0);
+    }
+    CHECK_THROWS(integer::to_string(10, 1), std::logic_error);
+    CHECK_THROWS(integer::to_string(10, 37), std::logic_error);
+    CHECK_THROWS(integer::create("10", 37), std::logic_error);
+    CHECK_THROWS(integer::create("12", 2), std::logic_error);
+}
+
+void check_decimal_and_hex()
+{
+    // Decimal strings of every length around the groups of eight digits converted at once and the chunks of 19.
+    std::string nines, digits;
+    for(int length = 1; length <= 60; length++)
+    {
+        nines += '9';
+        digits += static_cast<char>('0' + (length * 7) % 10);
+        CHECK(integer::create(nines, 10) + 1 == integer::create("1" + std::string(length, '0'), 10));
+        CHECK(integer::to_string(integer::create(nines, 10), 10) == nines);
+        CHECK(integer::remainder(integer::create(digits, 10), 1000000007u) == string_remainder(digits, 10, 1000000007u));
+        CHECK(integer::create("000" + digits, 10) == integer::create(digits, 10));
+    }
+    // Hex is read and written through tables, in either case, and its digits map straight onto bits.
+    CHECK(integer::create("DeadBeef0123456789abcdefABCDEF", 16) == integer::create("deadbeef0123456789ABCDEFabcdef", 16));
+    CHECK(integer::to_string(integer::create("deadbeef0123456789abcdef", 16)) == "DEADBEEF0123456789ABCDEF");
+    CHECK(integer::to_string(integer::create("0000abc", 16), 16, false) == "abc");
+    CHECK(integer::to_string(integer::shift_bits_left(1, 1000) - 1, 16) == std::string(250, 'F'));
+    CHECK(integer::to_string(integer::shift_bits_left(1, 1000), 16) == "1" + std::string(250, '0'));
+    CHECK(integer::to_string(integer::shift_bits_left(1, 1001), 8) == "4" + std::string(333, '0'));
+    CHECK(integer::to_string(integer::shift_bits_left(5, 999), 32) == "2G" + std::string(199, '0'));
+}
+
+// The value of a string of decimal digits, one digit at a time (so independently of the chunked and divide-and-conquer conversions).
+integer decimal_value(const std::string& str)
+{
+    integer x = 0;
+    for(const char c : str)
+    {
+        x = x * 10u + static_cast<unsigned>(c - '0');
+    }
+    return x;
+}
+
+// Pseudo-random decimal digits (the first one non-zero).
+std::string random_decimal(const std::size_t length, integer::superdigit& state)
+{
+    std::string str;
+    for(std::size_t i = 0; i < length; i++)
+    {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        str += static_cast<char>('0' + (state >> 33) % 10);
+    }
+    str[0] = str[0] == '0' ? '7' : str[0];
+    return str;
+}
+
+// Decimal lengths around the chunks of 19 digits, and around 32 chunks (608 digits, past which parsing and printing divide and
+// conquer) and its doublings.
+const std::size_t decimal_lengths[] = {1, 18, 19, 20, 37, 38, 39, 607, 608, 609, 627, 1215, 1216, 1217, 2431, 2432, 2433, 4871};
+
+void check_decimal_parsing()
+{
+    integer::superdigit state = 3;
+    for(const std::size_t length : decimal_lengths)
+    {
+        const std::string str = random_decimal(length, state);
+        const integer x = decimal_value(str);
+        CHECK(integer::create(str, 10) == x);
+        CHECK(integer::create("-" + str, 10) == -x);
+        // Leading zeroes, which move the chunk boundaries and can make the string cross a threshold its value does not.
+        for(const std::size_t zeroes : {1, 18, 19, 600, 1300})
+        {
+            CHECK(integer::create(std::string(zeroes, '0') + str, 10) == x);
+            CHECK(integer::create("-" + std::string(zeroes, '0') + str, 10) == -x);
+        }
+        CHECK(integer::create(std::string(length, '0'), 10) == 0);
+        // Runs of nines carry through every chunk, and a single one followed by zeroes is a power of ten.
+        CHECK(integer::create(std::string(length, '9'), 10) == decimal_value(std::string(length, '9')));
+        CHECK(integer::create("1" + std::string(length, '0'), 10) == decimal_value("1" + std::string(length, '0')));
+    }
+}
+
+// The decimal string of x, 19 digits at a time by word division (so independently of the divide-and-conquer conversion).
+std::string decimal_string(const integer& x)
+{
+    std::vector<std::string> chunks;
+    for(integer rest = integer::absolute_value(x); rest != 0;)
+    {
+        const auto [quotient, remainder] = integer::divide(rest, integer::superdigit(10000000000000000000u));
+        const std::string chunk = std::to_string(remainder);
+        chunks.push_back(quotient != 0 ? std::string(19 - chunk.size(), '0') + chunk : chunk);
+        rest = quotient;
+    }
+    std::string str = x < 0 ? "-" : chunks.empty() ? "0" : "";
+    for(auto it = chunks.rbegin(); it != chunks.rend(); ++it)
+    {
+        str += *it;
+    }
+    return str;
+}
+
+void check_decimal_printing()
+{
+    integer::superdigit state = 4;
+    for(const std::size_t length : decimal_lengths)
+    {
+        const integer power = decimal_value("1" + std::string(length, '0'));
+        // Random digits, and values whose lower halves are runs of zeroes or nines, which have to be padded to their full width.
+        const integer half = decimal_value("1" + std::string(length / 2, '0'));
+        for(const integer& x : {decimal_value(random_decimal(length, state)), power, power - 1, power + 1, power + half, power - half})
+        {
+            const std::string str = integer::to_string(x, 10);
+            CHECK(str == decimal_string(x));
+            CHECK(integer::to_string(-x, 10) == decimal_string(-x));
+            CHECK(integer::create(str, 10) == x);
+        }
+    }
+    CHECK(integer::to_string(0, 10) == "0");
+}
+
+void check_beyond_power_cache()
+{
+    // Powers of the chunk base are cached until one reaches 2^16 digits (which has up to 2^17), so a value of 2^18 digits needs the
+    // next one, squared on the spot, to be converted either way.
+    integer::superdigit state = 2;
+    const integer x = random_integer((1 << 18) + 100, state);
+    const std::string str = integer::to_string(x, 10);
+    CHECK(integer::remainder(x, 1000000007u) == string_remainder(str, 10, 1000000007u));
+    CHECK(integer::create(str, 10) == x);
+    // The cache stays consistent for the smaller values converted after it.
+    check_round_trip(random_integer(5000, state), 10);
+}
+
+int main()
+{
+    check_every_radix();
+    check_decimal_and_hex();
+    check_decimal_parsing();
+    check_decimal_printing();
+    check_beyond_power_cache();
+    return int_titan::test::result();
+}
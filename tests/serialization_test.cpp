@@ -0,0 +1,185 @@
+#include "integer.h"
+#include "tests/test.h"
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using int_titan::integer;
+using int_titan::test::random_integer;
+using endian = integer::endian;
+
+std::vector<unsigned char> serialize(const integer& x)
+{
+    std::vector<unsigned char> bytes(integer::serialized_size(x));
+    CHECK(integer::serialize(x, bytes.data()) == bytes.size());
+    return bytes;
+}
+
+integer deserialize(const std::vector<unsigned char>& bytes)
+{
+    return integer::deserialize(bytes.data(), bytes.size());
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+// The temporary file for load, named after the test executable (so that its variants can run at the same time).
+std::string temporary_path;
+
+// Write bytes to a temporary file and load it (memory-mapped).
+integer load(const std::vector<unsigned char>& bytes)
+{
+    const std::string& path = temporary_path;
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    try
+    {
+        const integer x = integer::load(path.c_str());
+        std::remove(path.c_str());
+        return x;
+    }
+    catch(...)
+    {
+        std::remove(path.c_str());
+        throw;
+    }
+}
+#endif
+
+void check_serialization()
+{
+    integer::superdigit state = 1;
+    // Values within a block and across the blocks of 2^14 digits that are checked and copied at once.
+    for(const integer& x : {integer(0), integer(1), integer(-1), random_integer(100, state), -random_integer(40000, state)})
+    {
+        const std::vector<unsigned char> bytes = serialize(x);
+        CHECK(bytes.size() == 24 + 4 * ((integer::bit_length(x) + 31) / 32));
+        CHECK(deserialize(bytes) == x);
+        std::stringstream stream;
+        integer::serialize(x, stream);
+        CHECK(stream.str() == std::string(bytes.begin(), bytes.end()));
+        CHECK(integer::deserialize(stream) == x);
+#if defined(__unix__) || defined(__APPLE__)
+        CHECK(load(bytes) == x);
+#endif
+    }
+    // The header: magic, version 1, sign, reserved byte and digit count.
+    const std::vector<unsigned char> bytes = serialize(integer::create("-123456789ABCDEF01", 16));
+    CHECK(std::string(bytes.begin(), bytes.begin() + 8) == std::string("ITTN\1\0\1\0", 8));
+    CHECK(bytes[8] == 3 and bytes[24] == 0x01 and bytes[25] == 0xEF and bytes[28] == 0x89 and bytes[32] == 0x01);
+}
+
+void check_invalid_data()
+{
+    integer::superdigit state = 2;
+    const std::vector<unsigned char> bytes = serialize(-random_integer(20000, state));
+    // Truncated anywhere, in the header or the digits (the file for load is then empty or shorter than the header, or cut in the digits).
+    for(const std::size_t size : {std::size_t(0), std::size_t(10), std::size_t(23), std::size_t(24), std::size_t(1000), bytes.size() - 1})
+    {
+        const std::vector<unsigned char> truncated(bytes.begin(), bytes.begin() + size);
+        CHECK_THROWS_MESSAGE(deserialize(truncated), std::runtime_error, "Invalid serialized integer.");
+        std::istringstream stream(std::string(truncated.begin(), truncated.end()));
+        CHECK_THROWS_MESSAGE(integer::deserialize(stream), std::runtime_error, "Invalid serialized integer.");
+#if defined(__unix__) || defined(__APPLE__)
+        CHECK_THROWS_MESSAGE(load(truncated), std::runtime_error, "Invalid serialized integer.");
+#endif
+    }
+    // A wrong magic, version, sign or reserved byte, a digit count too large or too small for the data, and a changed digit.
+    for(const auto& [position, value] : std::vector<std::pair<std::size_t, unsigned char>>{{0, 'X'}, {3, 'M'}, {4, 2}, {5, 1}, {6, 2}, {7, 1},
+                                                                                           {8, 0x21}, {8, 0x1F}, {13, 1}, {15, 0x80}, {1000, 0x55}})
+    {
+        std::vector<unsigned char> corrupted = bytes;
+        corrupted[position] ^= value;
+        CHECK_THROWS_MESSAGE(deserialize(corrupted), std::runtime_error, "Invalid serialized integer.");
+        std::istringstream stream(std::string(corrupted.begin(), corrupted.end()));
+        CHECK_THROWS_MESSAGE(integer::deserialize(stream), std::runtime_error, "Invalid serialized integer.");
+#if defined(__unix__) || defined(__APPLE__)
+        CHECK_THROWS_MESSAGE(load(corrupted), std::runtime_error, "Invalid serialized integer.");
+#endif
+    }
+    // Extra data after the digits is left to the caller.
+    std::vector<unsigned char> longer = bytes;
+    longer.push_back(0);
+    CHECK(deserialize(longer) == deserialize(bytes));
+#if defined(__unix__) || defined(__APPLE__)
+    CHECK_THROWS_MESSAGE(integer::load("serialization_test_missing.bin"), std::runtime_error, "Opening the file failed.");
+#endif
+}
+
+// The bytes of |x| in the given orders, from its little-endian bytes placed one by one.
+std::vector<unsigned char> expected_bytes(const integer& x, const std::size_t word_size, const bool is_little_word, const bool is_little_byte)
+{
+    const std::size_t count = integer::export_size(x, word_size);
+    std::vector<unsigned char> bytes(count * word_size);
+    for(std::size_t i = 0; i < bytes.size(); i++)
+    {
+        const std::size_t word = i / word_size, byte = i % word_size;
+        const std::size_t position = (is_little_word ? word : count - 1 - word) * word_size + (is_little_byte ? byte : word_size - 1 - byte);
+        bytes[position] = static_cast<unsigned char>(integer::to<unsigned>((integer::absolute_value(x) >> (8 * i)) & 0xFF));
+    }
+    return bytes;
+}
+
+void check_bytes()
+{
+    // A known layout.
+    const integer x = integer::create("0102030405060708090A", 16);
+    std::vector<unsigned char> buffer(16);
+    CHECK(integer::export_bytes(buffer.data(), 4, x, 4, endian::big, endian::big) == 3);
+    CHECK(std::vector<unsigned char>(buffer.begin(), buffer.begin() + 12) == std::vector<unsigned char>{0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+    CHECK(integer::export_bytes(buffer.data(), 4, x, 4, endian::little, endian::big) == 3);
+    CHECK(std::vector<unsigned char>(buffer.begin(), buffer.begin() + 12) == std::vector<unsigned char>{7, 8, 9, 10, 3, 4, 5, 6, 0, 0, 1, 2});
+    // Every order, for word sizes below, at and above a digit, and sizes that are not a whole number of digits.
+    integer::superdigit state = 3;
+    const endian orders[] = {endian::little, endian::big, endian::native};
+    const std::uint16_t probe = 1;
+    const bool is_little_native = *reinterpret_cast<const unsigned char*>(&probe) == 1;
+    for(const integer& value : {integer(0), integer(0xAB), -x, random_integer(3, state), random_integer(50, state)})
+    {
+        for(const std::size_t word_size : {1, 2, 3, 4, 5, 8, 13, 16})
+        {
+            for(const endian word_order : orders)
+            {
+                for(const endian byte_order : orders)
+                {
+                    const bool is_little_word = word_order == endian::little or (word_order == endian::native and is_little_native);
+                    const bool is_little_byte = byte_order == endian::little or (byte_order == endian::native and is_little_native);
+                    const std::size_t count = integer::export_size(value, word_size);
+                    std::vector<unsigned char> bytes(count * word_size + 1, 0xEE);
+                    CHECK(integer::export_bytes(bytes.data(), count, value, word_size, word_order, byte_order) == count);
+                    CHECK(bytes.back() == 0xEE);
+                    bytes.pop_back();
+                    CHECK(bytes == expected_bytes(value, word_size, is_little_word, is_little_byte));
+                    CHECK(integer::import_bytes(bytes.data(), count, word_size, word_order, byte_order) == integer::absolute_value(value));
+                }
+            }
+        }
+    }
+    // Leading zero words are dropped on import.
+    const unsigned char padded[] = {0, 0, 0, 0, 0, 0, 1, 2};
+    CHECK(integer::import_bytes(padded, 4, 2, endian::big, endian::big) == 0x102);
+    CHECK(integer::import_bytes(padded, 0, 2, endian::big, endian::big) == 0);
+    CHECK_THROWS(integer::export_bytes(buffer.data(), 2, x, 4, endian::big, endian::big), std::logic_error);
+    CHECK_THROWS(integer::export_size(x, 0), std::logic_error);
+    CHECK_THROWS(integer::import_bytes(padded, 4, 0, endian::big, endian::big), std::logic_error);
+    // Word counts whose size in bytes does not fit a size_t are rejected before anything is read or written.
+    const std::size_t huge = std::numeric_limits<std::size_t>::max() / 4 + 1;
+    CHECK_THROWS_MESSAGE(integer::import_bytes(padded, huge, 4, endian::big, endian::big), std::logic_error, "Byte count too large.");
+    CHECK_THROWS_MESSAGE(integer::import_bytes(padded, 4, huge, endian::little, endian::little), std::logic_error, "Byte count too large.");
+    CHECK_THROWS_MESSAGE(integer::import_bytes(padded, huge, huge, endian::little, endian::big), std::logic_error, "Byte count too large.");
+    // A word larger than the value takes one word, however large the word is.
+    CHECK(integer::export_size(x, std::numeric_limits<std::size_t>::max()) == 1);
+    CHECK(integer::export_size(x, huge) == 1);
+    CHECK(integer::export_size(0, std::numeric_limits<std::size_t>::max()) == 0);
+}
+
+int main(int, char** argv)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    temporary_path = std::string(argv[0]) + ".bin";
+#endif
+    check_serialization();
+    check_invalid_data();
+    check_bytes();
+    return int_titan::test::result();
+}
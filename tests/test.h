@@ -0,0 +1,91 @@
+#ifndef INTTITAN_TEST_H
+#define INTTITAN_TEST_H
+#include "integer.h"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+// Minimal checks for the test executables: a failed check is reported with its location, and the test returns the number of failures
+// from main (through int_titan::test::result()). The fixture values shared by the tests are built here too.
+namespace int_titan::test
+{
+    inline int failures = 0;
+
+    inline void check(const bool condition, const char* expression, const char* file, const int line)
+    {
+        if(!condition)
+        {
+            std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+            failures++;
+        }
+    }
+
+    inline int result()
+    {
+        return failures == 0 ? 0 : 1;
+    }
+
+    // Whether x carries a negative sign, a negative zero included (which compares and prints as 0, but keeps its sign through to_double).
+    inline bool has_negative_sign(const integer& x)
+    {
+        return std::signbit(integer::to_double(x));
+    }
+
+    // 2^n, built from its binary string rather than by shifting (so that it can check the shifts).
+    inline integer power_of_two(const std::size_t n)
+    {
+        return integer::create("1" + std::string(n, '0'), 2);
+    }
+
+    // A pseudo-random value of exactly 'digits' digits (the same for the same state, from a 64-bit LCG).
+    inline integer random_integer(const std::size_t digits, integer::superdigit& state)
+    {
+        std::string hex;
+        for(std::size_t i = 0; i < digits; i++)
+        {
+            state = state * 6364136223846793005u + 1442695040888963407u;
+            char word[9];
+            std::snprintf(word, sizeof(word), "%08X", static_cast<unsigned>(state >> 32));
+            hex += word;
+        }
+        hex[0] = hex[0] == '0' ? '1' : hex[0];
+        return integer::create(hex, 16);
+    }
+}
+
+#define CHECK(...) int_titan::test::check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+// Does the statement throw the exception type?
+#define CHECK_THROWS(statement, exception)                                                                                                 \
+    do                                                                                                                                     \
+    {                                                                                                                                      \
+        bool is_thrown = false;                                                                                                            \
+        try                                                                                                                                \
+        {                                                                                                                                  \
+            statement;                                                                                                                     \
+        }                                                                                                                                  \
+        catch(const exception&)                                                                                                            \
+        {                                                                                                                                  \
+            is_thrown = true;                                                                                                              \
+        }                                                                                                                                  \
+        int_titan::test::check(is_thrown, #statement " throws " #exception, __FILE__, __LINE__);                                           \
+    }                                                                                                                                      \
+    while(false)
+// Does the statement throw the exception type, with the given message?
+#define CHECK_THROWS_MESSAGE(statement, exception, message)                                                                                \
+    do                                                                                                                                     \
+    {                                                                                                                                      \
+        bool is_thrown = false;                                                                                                            \
+        try                                                                                                                                \
+        {                                                                                                                                  \
+            statement;                                                                                                                     \
+        }                                                                                                                                  \
+        catch(const exception& error)                                                                                                      \
+        {                                                                                                                                  \
+            is_thrown = std::string(error.what()) == (message);                                                                            \
+        }                                                                                                                                  \
+        int_titan::test::check(is_thrown, #statement " throws " #exception " \"" message "\"", __FILE__, __LINE__);                        \
+    }                                                                                                                                      \
+    while(false)
+
+#endif //INTTITAN_TEST_H